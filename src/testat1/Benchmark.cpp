@@ -0,0 +1,286 @@
+#include "calc.h"
+#include "columnCalc.h"
+#include "expression.h"
+#include "pipelinedPocketcalculator.h"
+#include "pocketcalculator.h"
+#include "sevensegment.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Lines per second of the pocketcalculator variants. Build with
+// optimisation, e.g.
+// g++ -std=c++20 -O2 -pthread Benchmark.cpp calc.cpp columnCalc.cpp expression.cpp
+// pipelinedPocketcalculator.cpp pocketcalculator.cpp sevensegment.cpp
+// and pass the number of lines and the ratio of malformed lines (0 to 1),
+// which is also the ratio of overflowing operands for calc and tryCalc.
+// The pipeline runs with 1 to N workers, N is the third argument and
+// defaults to the number of hardware threads.
+
+namespace {
+
+template <typename FUNCTION>
+double measure(FUNCTION && function) {
+	auto start = std::chrono::steady_clock::now();
+	function();
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	return elapsed.count();
+}
+
+void report(std::string const & name, std::size_t lines, double milliseconds, std::string const & unit = "lines") {
+	std::cout << std::left << std::setw(40) << name << std::right << std::setw(12) << std::fixed << std::setprecision(2) << milliseconds << " ms"
+			<< std::setw(14) << std::setprecision(0) << lines / milliseconds * 1000 << ' ' << unit << "/s\n";
+}
+
+std::string expressions(std::size_t lines, double malformedRatio, unsigned seed) {
+	std::mt19937 rng{seed};
+	std::uniform_int_distribution<int> operand{-99999, 99999};
+	std::uniform_int_distribution<int> operatorIndex{0, 4};
+	std::uniform_int_distribution<int> malformedKind{0, 2};
+	std::bernoulli_distribution malformed{malformedRatio};
+	std::string const operators{"+-*/%"};
+	std::ostringstream out{};
+	for (std::size_t i = 0; i < lines; i++) {
+		int lhs = operand(rng);
+		int rhs = operand(rng);
+		char op = operators[operatorIndex(rng)];
+		if (malformed(rng)) {
+			switch (malformedKind(rng)) {
+				case 0:
+					out << lhs << " / 0\n";
+					break;
+				case 1:
+					out << lhs << " ^ " << rhs << '\n';
+					break;
+				default:
+					out << lhs << ' ' << op << " x" << rhs << '\n';
+			}
+		} else {
+			if ((op == '/' || op == '%') && rhs == 0) {
+				rhs = 1;
+			}
+			out << lhs << ' ' << op << ' ' << rhs << '\n';
+		}
+	}
+	return out.str();
+}
+
+// one line after another through calc(std::istream &) and exceptions,
+// continuing after invalid lines
+void streamPerLine(std::istream & is, std::ostream & os) {
+	std::string line{};
+	while (std::getline(is, line)) {
+		std::istringstream lineStream{line};
+		try {
+			printLargeNumber(calc(lineStream), os);
+		} catch (std::exception const &) {
+			printLargeError(os);
+		}
+	}
+}
+
+template <typename CALCULATOR>
+void run(std::string const & name, std::string const & input, std::size_t lines, CALCULATOR calculator) {
+	std::istringstream in{input};
+	std::ostringstream out{};
+	double elapsed = measure([&] {
+		calculator(in, out);
+	});
+	report(name, lines, elapsed);
+}
+
+// operand pairs of which about overflowRatio overflow when multiplied
+std::vector<std::pair<int, int>> operands(std::size_t n, double overflowRatio, unsigned seed) {
+	std::mt19937 rng{seed};
+	std::uniform_int_distribution<int> small{-40000, 40000};
+	std::uniform_int_distribution<int> large{100000, 1000000};
+	std::bernoulli_distribution overflow{overflowRatio};
+	std::vector<std::pair<int, int>> pairs(n);
+	for (auto & pair : pairs) {
+		pair = overflow(rng) ? std::pair{large(rng), large(rng)} : std::pair{small(rng), small(rng)};
+	}
+	return pairs;
+}
+
+void benchmarkTryCalc(std::size_t n, double overflowRatio) {
+	std::cout << std::defaultfloat << "--- " << n << " multiplications, " << overflowRatio << " overflowing ---\n";
+	auto pairs = operands(n, overflowRatio, 2);
+	long long sum = 0;
+	std::size_t errors = 0;
+	double elapsed = measure([&] {
+		for (auto [lhs, rhs] : pairs) {
+			try {
+				sum += calc(lhs, rhs, '*');
+			} catch (std::exception const &) {
+				errors++;
+			}
+		}
+	});
+	report("calc, exceptions", n, elapsed, "calls");
+	elapsed = measure([&] {
+		for (auto [lhs, rhs] : pairs) {
+			auto result = tryCalc(lhs, rhs, '*');
+			if (result) {
+				sum += result.value;
+			} else {
+				errors++;
+			}
+		}
+	});
+	report("tryCalc", n, elapsed, "calls");
+	std::cout << "(both runs: checksum " << sum << ", " << errors << " errors)\n";
+}
+
+void benchmarkExpressions(std::size_t n) {
+	std::string const source{"(a + b) * c - d / (e + 1) % 7 + -a"};
+	std::cout << "--- " << n << " evaluations of " << source << " ---\n";
+	std::mt19937 rng{3};
+	std::uniform_int_distribution<int> operand{0, 1000};
+	std::vector<std::array<int, 5>> bindings(n);
+	for (auto & values : bindings) {
+		for (auto & value : values) {
+			value = operand(rng);
+		}
+	}
+	long long sum = 0;
+	double elapsed = measure([&] {
+		for (auto const & values : bindings) {
+			sum += compiledExpression{source}.evaluate(values).value;
+		}
+	});
+	report("parse every time", n, elapsed, "evaluations");
+	expressionCache cache{};
+	elapsed = measure([&] {
+		for (auto const & values : bindings) {
+			sum += cache.get(source).evaluate(values).value;
+		}
+	});
+	report("cache lookup, evaluate", n, elapsed, "evaluations");
+	elapsed = measure([&] {
+		compiledExpression const compiled{source};
+		for (auto const & values : bindings) {
+			sum += compiled.evaluate(values).value;
+		}
+	});
+	report("compile once, evaluate many", n, elapsed, "evaluations");
+	std::cout << "(all runs: checksum " << sum << ")\n";
+}
+
+void benchmarkColumns(std::size_t n) {
+	std::cout << "--- columns of " << n << " ints ---\n";
+	std::mt19937 rng{4};
+	std::uniform_int_distribution<int> operand{-40000, 40000};
+	std::vector<int> lhs(n), rhs(n), out(n);
+	for (std::size_t i = 0; i < n; i++) {
+		lhs[i] = operand(rng);
+		rhs[i] = operand(rng);
+	}
+	std::vector<std::uint64_t> errors(errorWords(n));
+	long long sum = 0;
+	for (char op : std::string{"+-*/%"}) {
+		std::string const name{op};
+		double elapsed = measure([&] {
+			for (std::size_t i = 0; i < n; i++) {
+				try {
+					out[i] = calc(lhs[i], rhs[i], op);
+				} catch (std::exception const &) {
+					out[i] = 0;
+				}
+			}
+		});
+		sum += out[n / 2];
+		report(name + " scalar calc", n, elapsed, "elements");
+		elapsed = measure([&] {
+			for (std::size_t i = 0; i < n; i++) {
+				out[i] = tryCalc(lhs[i], rhs[i], op).value;
+			}
+		});
+		sum += out[n / 2];
+		report(name + " scalar tryCalc", n, elapsed, "elements");
+		elapsed = measure([&] {
+			calc(lhs, rhs, op, out, errors);
+		});
+		sum += out[n / 2];
+		report(name + " column calc", n, elapsed, "elements");
+	}
+	std::cout << "(all runs: checksum " << sum << ")\n";
+}
+
+void benchmarkRendering(std::size_t n) {
+	std::cout << "--- rendering " << n << " numbers ---\n";
+	std::mt19937 rng{5};
+	std::uniform_int_distribution<int> number{-99999999, 99999999};
+	std::vector<int> numbers(n);
+	for (auto & value : numbers) {
+		value = number(rng);
+	}
+	std::size_t size = 0;
+	auto print = [&](std::string const & name, auto printer) {
+		std::ostringstream out{};
+		double elapsed = measure([&] {
+			for (int value : numbers) {
+				printer(value, out);
+			}
+		});
+		size += out.str().size();
+		report(name, n, elapsed, "numbers");
+	};
+	print("printLargeNumber", [](int value, std::ostream & out) {
+		printLargeNumber(value, out);
+	});
+	print("printLargeNumber, display width", [](int value, std::ostream & out) {
+		printLargeNumber(value, out, 9);
+	});
+	std::array<char, maxRenderedSize> buffer;
+	double elapsed = measure([&] {
+		for (int value : numbers) {
+			size += renderLargeNumber(value, buffer);
+		}
+	});
+	report("renderLargeNumber into a buffer", n, elapsed, "numbers");
+	std::cout << "(all runs: " << size << " characters)\n";
+}
+
+void benchmarkPipeline(std::string const & input, std::size_t lines, unsigned maxWorkers) {
+	std::cout << "--- pipeline, " << lines << " lines ---\n";
+	run("batchPocketcalculator", input, lines, batchPocketcalculator);
+	for (unsigned workers = 1; workers <= maxWorkers; workers++) {
+		pipelineOptions options{};
+		options.workers = workers;
+		run("pipelined, " + std::to_string(workers) + " workers", input, lines, [&](std::istream & is, std::ostream & os) {
+			pipelinedPocketcalculator(is, os, options);
+		});
+	}
+}
+
+}
+
+int main(int argc, char const *argv[]) {
+	std::size_t lines = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+	double malformedRatio = argc > 2 ? std::strtod(argv[2], nullptr) : 0.1;
+	std::cout << "--- " << lines << " lines, " << malformedRatio << " malformed ---\n";
+	auto input = expressions(lines, malformedRatio, 1);
+	run("stream per line, exceptions", input, lines, streamPerLine);
+	run("batchPocketcalculator", input, lines, batchPocketcalculator);
+	if (malformedRatio == 0) {
+		run("pocketcalculator", input, lines, pocketcalculator);
+	}
+	benchmarkTryCalc(10 * lines, malformedRatio);
+	benchmarkExpressions(lines);
+	benchmarkColumns(10 * lines);
+	benchmarkRendering(lines);
+	unsigned maxWorkers = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : std::max(std::thread::hardware_concurrency(), 1u);
+	benchmarkPipeline(input, lines, maxWorkers);
+}
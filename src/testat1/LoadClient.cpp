@@ -0,0 +1,177 @@
+#include "calculatorServer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Load generator for calculatorServer. Every client opens a session, sends
+// one expression at a time and waits for its five line answer. Reports
+// the latency percentiles and the requests per second of all clients, e.g.
+// g++ -std=c++20 -O2 -pthread LoadClient.cpp calculatorServer.cpp pocketcalculator.cpp calc.cpp sevensegment.cpp
+// Arguments: clients, requests per client and the socket path of a running
+// server. Without a path the server runs in this process.
+
+namespace {
+
+using steadyClock = std::chrono::steady_clock;
+
+// closes the connection however the session ends
+struct connection {
+	int descriptor;
+
+	explicit connection(std::string const & path) : descriptor{::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0)} {
+		if (descriptor < 0) {
+			throw std::system_error(errno, std::generic_category(), "Can not create a socket");
+		}
+		sockaddr_un address{};
+		address.sun_family = AF_UNIX;
+		std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+		if (::connect(descriptor, reinterpret_cast<sockaddr const *>(&address), sizeof(address)) != 0) {
+			int error = errno;
+			::close(descriptor);
+			throw std::system_error(error, std::generic_category(), "Can not connect to " + path);
+		}
+	}
+	connection(connection const &) = delete;
+	connection & operator=(connection const &) = delete;
+	~connection() {
+		::close(descriptor);
+	}
+};
+
+// latencies of the requests of one session in microseconds
+std::vector<double> session(std::string const & path, std::size_t requests, unsigned seed) {
+	std::mt19937 rng{seed};
+	std::uniform_int_distribution<int> operand{-9999, 9999};
+	std::string const operators{"+-*/%"};
+	std::uniform_int_distribution<int> operatorIndex{0, 4};
+	std::vector<double> latencies{};
+	latencies.reserve(requests);
+	connection server{path};
+	int const descriptor = server.descriptor;
+	char buffer[4096];
+	for (std::size_t i = 0; i < requests; i++) {
+		std::string request = std::to_string(operand(rng)) + ' ' + operators[operatorIndex(rng)] + ' ' + std::to_string(operand(rng)) + '\n';
+		auto start = steadyClock::now();
+		if (::send(descriptor, request.data(), request.size(), MSG_NOSIGNAL) != static_cast<ssize_t>(request.size())) {
+			throw std::system_error(errno, std::generic_category(), "Can not send a request");
+		}
+		// every answer has five rows
+		int rows = 0;
+		while (rows < 5) {
+			auto read = ::recv(descriptor, buffer, sizeof(buffer), 0);
+			if (read < 0) {
+				throw std::system_error(errno, std::generic_category(), "Can not receive an answer");
+			}
+			if (read == 0) {
+				throw std::runtime_error{"The server closed the session"};
+			}
+			rows += std::count(buffer, buffer + read, '\n');
+		}
+		std::chrono::duration<double, std::micro> elapsed = steadyClock::now() - start;
+		latencies.push_back(elapsed.count());
+	}
+	return latencies;
+}
+
+// sorted must not be empty
+double percentile(std::vector<double> const & sorted, double p) {
+	return sorted[std::min(sorted.size() - 1, static_cast<std::size_t>(p * sorted.size()))];
+}
+
+}
+
+int main(int argc, char const *argv[]) {
+	unsigned clients = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 16;
+	std::size_t requests = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10000;
+	std::string path = argc > 3 ? argv[3] : "/tmp/calculatorServer-" + std::to_string(::getpid());
+	if (clients == 0 || requests == 0) {
+		std::cerr << "usage: " << argv[0] << " [clients > 0] [requests per client > 0] [socket path]\n";
+		return 2;
+	}
+
+	std::unique_ptr<calculatorServer> server{};
+	std::thread serving{};
+	std::exception_ptr serverError{};
+	if (argc <= 3) {
+		try {
+			server = std::make_unique<calculatorServer>(path);
+		} catch (std::exception const & e) {
+			std::cerr << e.what() << '\n';
+			return 1;
+		}
+		serving = std::thread{[&] {
+			try {
+				server->run();
+			} catch (...) {
+				serverError = std::current_exception();
+			}
+		}};
+	}
+
+	std::vector<std::vector<double>> latencies(clients);
+	std::vector<std::exception_ptr> errors(clients);
+	std::vector<std::thread> threads{};
+	auto start = steadyClock::now();
+	for (unsigned i = 0; i < clients; i++) {
+		threads.emplace_back([&, i] {
+			try {
+				latencies[i] = session(path, requests, i);
+			} catch (...) {
+				errors[i] = std::current_exception();
+			}
+		});
+	}
+	for (auto & thread : threads) {
+		thread.join();
+	}
+	std::chrono::duration<double> elapsed = steadyClock::now() - start;
+
+	if (server) {
+		server->stop();
+		serving.join();
+		errors.push_back(serverError);
+		server.reset();
+	}
+
+	bool failed = false;
+	for (auto const & error : errors) {
+		if (error) {
+			try {
+				std::rethrow_exception(error);
+			} catch (std::exception const & e) {
+				std::cerr << e.what() << '\n';
+			}
+			failed = true;
+		}
+	}
+	if (failed) {
+		return 1;
+	}
+
+	std::vector<double> all{};
+	for (auto const & l : latencies) {
+		all.insert(all.end(), l.begin(), l.end());
+	}
+	std::sort(all.begin(), all.end());
+	std::cout << clients << " clients, " << requests << " requests each\n" << std::fixed << std::setprecision(1)
+			<< "p50     " << std::setw(10) << percentile(all, 0.5) << " us\n"
+			<< "p99     " << std::setw(10) << percentile(all, 0.99) << " us\n"
+			<< "max     " << std::setw(10) << all.back() << " us\n"
+			<< "rate    " << std::setw(10) << std::setprecision(0) << all.size() / elapsed.count() << " requests/s\n";
+}
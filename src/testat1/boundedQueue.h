@@ -0,0 +1,138 @@
+#ifndef BOUNDEDQUEUE
+#define BOUNDEDQUEUE
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+// Bounded lock-free queue for many producers and consumers (Dmitry Vyukov's
+// array queue). Every cell carries a sequence number that tells whether it
+// is free for the push of round pos or holds the value for the pop of round
+// pos. A push or pop claims its position with one compare-exchange and
+// does not wait for other threads unless the queue is full or empty. Then
+// push and pop spin for a while and block on a counter of completed pops
+// or pushes, which is only notified if some thread blocks.
+template <typename T>
+class boundedQueue {
+	struct cell {
+		std::atomic<std::size_t> sequence;
+		T value;
+	};
+
+	static constexpr int spins = 64;
+
+	std::unique_ptr<cell[]> cells;
+	std::size_t mask;
+	alignas(64) std::atomic<std::size_t> pushPosition{0};
+	alignas(64) std::atomic<std::size_t> popPosition{0};
+	alignas(64) std::atomic<std::uint32_t> pushes{0};
+	std::atomic<int> blockedPoppers{0};
+	alignas(64) std::atomic<std::uint32_t> pops{0};
+	std::atomic<int> blockedPushers{0};
+
+	static void completed(std::atomic<std::uint32_t> & counter, std::atomic<int> const & blocked) {
+		counter.fetch_add(1);
+		if (blocked.load() != 0) {
+			counter.notify_all();
+		}
+	}
+
+	// retries attempt until it succeeds, blocking on counter after a few spins
+	template <typename ATTEMPT>
+	static void retry(ATTEMPT attempt, std::atomic<std::uint32_t> & counter, std::atomic<int> & blocked) {
+		for (int i = 0; i < spins; i++) {
+			if (attempt()) {
+				return;
+			}
+		}
+		while (true) {
+			// read before the attempt, so a completion after it changes the counter
+			std::uint32_t seen = counter.load();
+			if (attempt()) {
+				return;
+			}
+			blocked.fetch_add(1);
+			counter.wait(seen);
+			blocked.fetch_sub(1);
+		}
+	}
+
+public:
+	// the capacity is rounded up to a power of two, at least 2
+	explicit boundedQueue(std::size_t capacity)
+		: cells{new cell[std::bit_ceil(std::max<std::size_t>(capacity, 2))]}, mask{std::bit_ceil(std::max<std::size_t>(capacity, 2)) - 1} {
+		for (std::size_t i = 0; i <= mask; i++) {
+			cells[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+	boundedQueue(boundedQueue const &) = delete;
+	boundedQueue & operator=(boundedQueue const &) = delete;
+
+	std::size_t capacity() const {
+		return mask + 1;
+	}
+
+	// moves value into the queue, value is untouched if the queue is full
+	bool tryPush(T & value) {
+		std::size_t position = pushPosition.load(std::memory_order_relaxed);
+		while (true) {
+			cell & c = cells[position & mask];
+			std::size_t sequence = c.sequence.load(std::memory_order_acquire);
+			auto difference = static_cast<std::ptrdiff_t>(sequence - position);
+			if (difference == 0) {
+				if (pushPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+					c.value = std::move(value);
+					c.sequence.store(position + 1, std::memory_order_release);
+					completed(pushes, blockedPoppers);
+					return true;
+				}
+			} else if (difference < 0) {
+				return false;
+			} else {
+				position = pushPosition.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	bool tryPop(T & value) {
+		std::size_t position = popPosition.load(std::memory_order_relaxed);
+		while (true) {
+			cell & c = cells[position & mask];
+			std::size_t sequence = c.sequence.load(std::memory_order_acquire);
+			auto difference = static_cast<std::ptrdiff_t>(sequence - (position + 1));
+			if (difference == 0) {
+				if (popPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+					value = std::move(c.value);
+					c.sequence.store(position + mask + 1, std::memory_order_release);
+					completed(pops, blockedPushers);
+					return true;
+				}
+			} else if (difference < 0) {
+				return false;
+			} else {
+				position = popPosition.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	// push and pop block while the queue is full or empty
+	void push(T value) {
+		retry([&] {
+			return tryPush(value);
+		}, pops, blockedPushers);
+	}
+
+	T pop() {
+		T value{};
+		retry([&] {
+			return tryPop(value);
+		}, pushes, blockedPoppers);
+		return value;
+	}
+};
+
+#endif
@@ -1,36 +1,60 @@
 #include "calc.h" //Eigener Include zuerst
 
+#include <charconv>
 #include <istream> //Gut
+#include <limits>
 #include <stdexcept>
 
-int calc(int lhs, int rhs, char op) {
-	int result = 0; //Den Umweg ueber die lokale Variable breauchte es nicht. Direkt mit return das Resultat zurueckgeben waere besser.
+calcResult tryCalc(int lhs, int rhs, char op) noexcept {
+	int result = 0;
+	bool overflow = false;
 
 	switch (op)
 	{
 		case '+':
-			result = lhs + rhs;
+			overflow = __builtin_add_overflow(lhs, rhs, &result);
 			break;
 		case '-' :
-			result = lhs - rhs;
+			overflow = __builtin_sub_overflow(lhs, rhs, &result);
 			break;
 		case '*' :
-			result = lhs * rhs;
+			overflow = __builtin_mul_overflow(lhs, rhs, &result);
 			break;
 		case '/' :
-			//Gut / 0 abgefangen
-			if (rhs == 0) throw std::invalid_argument("Division by 0 is forbidden!"); //Auch Exceptions mit {} initialisieren
-			result =  lhs / rhs;
+			if (rhs == 0) return {0, calcError::divisionByZero};
+			// INT_MIN / -1 is the only quotient that does not fit
+			overflow = lhs == std::numeric_limits<int>::min() && rhs == -1;
+			result = overflow ? 0 : lhs / rhs;
 			break;
 		case '%' :
-			//Gut % 0 abgefangen
-			if (rhs == 0) throw std::invalid_argument("Modulo by 0 is forbidden!");
-			result = lhs % rhs;
+			if (rhs == 0) return {0, calcError::moduloByZero};
+			// INT_MIN % -1 is 0, but traps on x86
+			result = rhs == -1 ? 0 : lhs % rhs;
 			break;
-			//Gut, ungueltigen Operator abgefangen
-		default:  throw std::invalid_argument("Not available operator used.");
+		default:
+			return {0, calcError::unknownOperator};
+	}
+	if (overflow) {
+		return {0, calcError::overflow};
+	}
+	return {result, calcError::none};
+}
+
+int calc(int lhs, int rhs, char op) {
+	auto const result = tryCalc(lhs, rhs, op);
+	switch (result.error)
+	{
+		case calcError::none:
+			return result.value;
+		case calcError::divisionByZero:
+			throw std::invalid_argument{"Division by 0 is forbidden!"};
+		case calcError::moduloByZero:
+			throw std::invalid_argument{"Modulo by 0 is forbidden!"};
+		case calcError::overflow:
+			throw std::overflow_error{"Result does not fit into an int!"};
+		default:
+			throw std::invalid_argument{"Not available operator used."};
 	}
-	return result;
 }
 
 int calc(std::istream & in) {
@@ -43,3 +67,52 @@ int calc(std::istream & in) {
 	throw std::invalid_argument{"Invalid input!"};
 
 }
+
+namespace {
+
+bool isSpace(char c) {
+	return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+char const * skipSpace(char const * first, char const * last) {
+	while (first != last && isSpace(*first)) {
+		++first;
+	}
+	return first;
+}
+
+// reads an int like operator>>, which also accepts a leading '+'
+char const * parseInt(char const * first, char const * last, int & value) {
+	first = skipSpace(first, last);
+	if (first != last && *first == '+' && last - first > 1 && first[1] != '-') {
+		++first;
+	}
+	auto [end, error] = std::from_chars(first, last, value);
+	return error == std::errc{} ? end : nullptr;
+}
+
+}
+
+calcError calcLine(std::string_view line, int & result) noexcept {
+	char const * last = line.data() + line.size();
+	int lhs, rhs;
+	char const * position = parseInt(line.data(), last, lhs);
+	if (!position) {
+		return calcError::invalidInput;
+	}
+	position = skipSpace(position, last);
+	if (position == last) {
+		return calcError::invalidInput;
+	}
+	char op = *position++;
+	position = parseInt(position, last, rhs);
+	if (!position || skipSpace(position, last) != last) {
+		return calcError::invalidInput;
+	}
+
+	auto const evaluated = tryCalc(lhs, rhs, op);
+	if (evaluated) {
+		result = evaluated.value;
+	}
+	return evaluated.error;
+}
@@ -1,8 +1,33 @@
 #ifndef CALC //Guard vorhanden
 #define CALC
 #include <iosfwd> //Korrekter include
+#include <string_view>
 
+// both throw std::invalid_argument for invalid input and std::overflow_error
+// for results that do not fit into an int
 int calc(int lhs, int rhs, char op); //Deklarationen sind korrekt
 int calc(std::istream & in);
 
+// the exceptions of calc as return codes
+enum class calcError { none, invalidInput, divisionByZero, moduloByZero, unknownOperator, overflow };
+
+// value is only meaningful without error
+struct calcResult {
+	int value;
+	calcError error;
+
+	explicit operator bool() const {
+		return error == calcError::none;
+	}
+};
+
+// Like calc(lhs, rhs, op), but reports errors instead of throwing. Results
+// that do not fit into an int are reported as overflow.
+calcResult tryCalc(int lhs, int rhs, char op) noexcept;
+
+// Evaluates one line holding "lhs op rhs", surrounded by optional white
+// space, like calc(std::istream &) but without streams and exceptions.
+// Anything after rhs other than white space is invalid input.
+calcError calcLine(std::string_view line, int & result) noexcept;
+
 #endif
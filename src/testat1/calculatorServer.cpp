@@ -0,0 +1,237 @@
+#include "calculatorServer.h"
+#include "pocketcalculator.h"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr std::size_t readSize = 64 * 1024;
+constexpr int maxEvents = 64;
+
+[[noreturn]] void fail(char const * what) {
+	throw std::system_error(errno, std::generic_category(), what);
+}
+
+// input not yet evaluated and output not yet sent of one connection
+struct session {
+	std::string input{};
+	std::string output{};
+	std::size_t sent{0};
+	bool inputClosed{false};
+	std::uint32_t watched{EPOLLIN | EPOLLRDHUP};
+};
+
+void watch(int events, int operation, int descriptor, std::uint32_t mask) {
+	epoll_event event{};
+	event.events = mask;
+	event.data.fd = descriptor;
+	if (::epoll_ctl(events, operation, descriptor, &event) != 0) {
+		fail("epoll_ctl");
+	}
+}
+
+// evaluates the complete lines, all of them once the client closed its side
+void evaluate(session & s) {
+	std::size_t complete = s.inputClosed ? s.input.size() : s.input.rfind('\n') + 1;
+	if (complete == 0) {
+		return;
+	}
+	evaluateLines(std::string_view{s.input}.substr(0, complete), s.output);
+	s.input.erase(0, complete);
+}
+
+// false if the connection failed
+bool send(int descriptor, session & s) {
+	while (s.sent < s.output.size()) {
+		auto written = ::send(descriptor, s.output.data() + s.sent, s.output.size() - s.sent, MSG_NOSIGNAL);
+		if (written < 0) {
+			if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+				return false;
+			}
+			// drop the sent prefix once it is the larger part, so a client
+			// that reads slower than it sends can not grow output forever
+			if (s.sent >= s.output.size() - s.sent) {
+				s.output.erase(0, s.sent);
+				s.sent = 0;
+			}
+			return true;
+		}
+		s.sent += written;
+	}
+	s.output.clear();
+	s.sent = 0;
+	return true;
+}
+
+// false if the connection failed or the client sent a too long line
+bool receive(int descriptor, session & s) {
+	char buffer[readSize];
+	while (s.output.size() - s.sent < calculatorServer::maxPendingOutput) {
+		auto read = ::recv(descriptor, buffer, sizeof(buffer), 0);
+		if (read > 0) {
+			s.input.append(buffer, read);
+			evaluate(s);
+			if (s.input.size() > calculatorServer::maxLineLength) {
+				return false;
+			}
+		} else if (read == 0) {
+			s.inputClosed = true;
+			evaluate(s);
+			return true;
+		} else {
+			return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+		}
+	}
+	return true;
+}
+
+// Removes a socket file nobody accepts connections on any more. Other
+// files and sockets of running servers are left, bind then fails.
+void removeStaleSocket(std::string const & path, sockaddr_un const & address) {
+	struct stat status{};
+	if (::lstat(path.c_str(), &status) != 0 || !S_ISSOCK(status.st_mode)) {
+		return;
+	}
+	int probe = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if (probe < 0) {
+		return;
+	}
+	bool refused = ::connect(probe, reinterpret_cast<sockaddr const *>(&address), sizeof(address)) != 0 && errno == ECONNREFUSED;
+	::close(probe);
+	if (refused) {
+		::unlink(path.c_str());
+	}
+}
+
+}
+
+calculatorServer::calculatorServer(std::string path) : path{std::move(path)} {
+	sockaddr_un address{};
+	address.sun_family = AF_UNIX;
+	if (this->path.size() >= sizeof(address.sun_path)) {
+		throw std::system_error(std::make_error_code(std::errc::filename_too_long), this->path);
+	}
+	std::memcpy(address.sun_path, this->path.c_str(), this->path.size() + 1);
+
+	try {
+		listener = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+		events = ::epoll_create1(EPOLL_CLOEXEC);
+		wakeup = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+		if (listener < 0 || events < 0 || wakeup < 0) {
+			fail("Can not create the server");
+		}
+		removeStaleSocket(this->path, address);
+		if (::bind(listener, reinterpret_cast<sockaddr const *>(&address), sizeof(address)) != 0) {
+			fail("Can not bind the socket");
+		}
+		struct stat status{};
+		if (::lstat(this->path.c_str(), &status) == 0) {
+			boundDevice = status.st_dev;
+			boundInode = status.st_ino;
+		}
+		if (::listen(listener, SOMAXCONN) != 0) {
+			fail("Can not listen on the socket");
+		}
+		watch(events, EPOLL_CTL_ADD, listener, EPOLLIN);
+		watch(events, EPOLL_CTL_ADD, wakeup, EPOLLIN);
+	} catch (...) {
+		release();
+		throw;
+	}
+}
+
+calculatorServer::~calculatorServer() {
+	release();
+}
+
+void calculatorServer::release() {
+	for (int * descriptor : {&listener, &events, &wakeup}) {
+		if (*descriptor >= 0) {
+			::close(*descriptor);
+			*descriptor = -1;
+		}
+	}
+	// a newer server may have replaced the file in the meantime
+	struct stat status{};
+	if (boundInode != 0 && ::lstat(path.c_str(), &status) == 0 && status.st_dev == boundDevice && status.st_ino == boundInode) {
+		::unlink(path.c_str());
+	}
+	boundInode = 0;
+}
+
+void calculatorServer::stop() {
+	std::uint64_t one = 1;
+	// only fails if the counter is already huge, then run wakes up anyway
+	[[maybe_unused]] auto written = ::write(wakeup, &one, sizeof(one));
+}
+
+void calculatorServer::run() {
+	std::unordered_map<int, session> sessions{};
+	auto close = [&](int descriptor) {
+		::close(descriptor);
+		sessions.erase(descriptor);
+	};
+	epoll_event ready[maxEvents];
+	while (true) {
+		int count = ::epoll_wait(events, ready, maxEvents, -1);
+		if (count < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			fail("epoll_wait");
+		}
+		for (int i = 0; i < count; i++) {
+			int descriptor = ready[i].data.fd;
+			if (descriptor == wakeup) {
+				for (auto const & entry : sessions) {
+					::close(entry.first);
+				}
+				std::uint64_t value;
+				[[maybe_unused]] auto read = ::read(wakeup, &value, sizeof(value));
+				return;
+			}
+			if (descriptor == listener) {
+				for (int client; (client = ::accept4(listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0;) {
+					watch(events, EPOLL_CTL_ADD, client, EPOLLIN | EPOLLRDHUP);
+					sessions.try_emplace(client);
+				}
+				continue;
+			}
+			auto found = sessions.find(descriptor);
+			if (found == sessions.end()) {
+				continue;
+			}
+			session & s = found->second;
+			bool ok = true;
+			if (ready[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP)) {
+				ok = s.inputClosed || receive(descriptor, s);
+			}
+			ok = ok && !(ready[i].events & EPOLLERR) && send(descriptor, s);
+			if (!ok || (s.inputClosed && s.output.empty())) {
+				close(descriptor);
+				continue;
+			}
+			// read while the output is small, wait for writability while any is left
+			bool reading = !s.inputClosed && s.output.size() - s.sent < maxPendingOutput;
+			std::uint32_t mask = (reading ? EPOLLIN | EPOLLRDHUP : 0) | (s.output.empty() ? 0u : std::uint32_t{EPOLLOUT});
+			if (mask != s.watched) {
+				watch(events, EPOLL_CTL_MOD, descriptor, mask);
+				s.watched = mask;
+			}
+		}
+	}
+}
@@ -0,0 +1,46 @@
+#ifndef CALCULATORSERVER
+#define CALCULATORSERVER
+
+#include <cstddef>
+#include <string>
+
+// Long running pocketcalculator service on a Unix domain socket. Every
+// connection is a session with the semantics of batchPocketcalculator: each
+// line the client sends is answered with a large number or the error
+// display. One thread multiplexes all sessions with epoll on non-blocking
+// sockets. A session stops being read while maxPendingOutput bytes of its
+// answers are unsent, so a slow client only stalls itself and holds at
+// most about that much memory. A session whose line grows beyond
+// maxLineLength bytes is closed.
+class calculatorServer {
+	int listener{-1};
+	int events{-1};
+	int wakeup{-1};
+	std::string path;
+	// identity of the socket file this server bound, 0 before binding
+	unsigned long long boundDevice{0};
+	unsigned long long boundInode{0};
+
+public:
+	static constexpr std::size_t maxPendingOutput = 1024 * 1024;
+	static constexpr std::size_t maxLineLength = 1024 * 1024;
+
+	// Binds and listens on path. A socket file left by a server that no
+	// longer accepts connections is replaced, anything else at path makes
+	// it throw std::system_error, like any other failure.
+	explicit calculatorServer(std::string path);
+	calculatorServer(calculatorServer const &) = delete;
+	calculatorServer & operator=(calculatorServer const &) = delete;
+	// closes all descriptors and removes the socket file if it is still ours
+	~calculatorServer();
+
+	// serves sessions until stop is called
+	void run();
+	// may be called from any thread and from signal handlers
+	void stop();
+
+private:
+	void release();
+};
+
+#endif
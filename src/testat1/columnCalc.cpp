@@ -0,0 +1,144 @@
+#include "columnCalc.h"
+#include "calc.h"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <stdexcept>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+// elements per error word, and per call of a kernel
+constexpr std::size_t blockSize = 64;
+
+#if defined(__SSE2__)
+
+// one bit per lane, set where the lane is negative
+std::uint64_t signBits(__m128i v) {
+	return static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(v)));
+}
+
+// the low 32 bits of the lane wise products, SSE2 has no pmulld
+__m128i multiplyLow(__m128i a, __m128i b) {
+	__m128i even = _mm_mul_epu32(a, b);
+	__m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+	return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+// Lanes where a * b does not fit into an int. The products of two lanes at
+// a time are computed as doubles, they are exact up to 2^53 and larger ones
+// are out of range anyway.
+__m128i multiplyOverflow(__m128i a, __m128i b) {
+	__m128d const lowest = _mm_set1_pd(std::numeric_limits<int>::min());
+	__m128d const highest = _mm_set1_pd(std::numeric_limits<int>::max());
+	auto outside = [&](__m128i x, __m128i y) {
+		__m128d product = _mm_mul_pd(_mm_cvtepi32_pd(x), _mm_cvtepi32_pd(y));
+		return _mm_or_pd(_mm_cmplt_pd(product, lowest), _mm_cmpgt_pd(product, highest));
+	};
+	__m128d low = outside(a, b);
+	__m128d high = outside(_mm_unpackhi_epi64(a, a), _mm_unpackhi_epi64(b, b));
+	return _mm_castps_si128(_mm_shuffle_ps(_mm_castpd_ps(low), _mm_castpd_ps(high), _MM_SHUFFLE(2, 0, 2, 0)));
+}
+
+// Truncated quotients. The double quotient of two ints is never rounded
+// across an integer, so truncating it gives the exact int quotient. The
+// divisor must not be 0, INT_MIN / -1 yields INT_MIN.
+__m128i divide(__m128i a, __m128i b) {
+	__m128i low = _mm_cvttpd_epi32(_mm_div_pd(_mm_cvtepi32_pd(a), _mm_cvtepi32_pd(b)));
+	__m128i high = _mm_cvttpd_epi32(_mm_div_pd(_mm_cvtepi32_pd(_mm_unpackhi_epi64(a, a)), _mm_cvtepi32_pd(_mm_unpackhi_epi64(b, b))));
+	return _mm_unpacklo_epi64(low, high);
+}
+
+// Computes four lanes and returns their error bits.
+// Faulty lanes are set to 0.
+template <char OP>
+std::uint64_t kernel(int const * lhs, int const * rhs, int * out) {
+	__m128i a = _mm_loadu_si128(reinterpret_cast<__m128i const *>(lhs));
+	__m128i b = _mm_loadu_si128(reinterpret_cast<__m128i const *>(rhs));
+	__m128i result;
+	__m128i error;
+	if constexpr (OP == '+') {
+		result = _mm_add_epi32(a, b);
+		error = _mm_and_si128(_mm_xor_si128(a, result), _mm_xor_si128(b, result));
+		error = _mm_srai_epi32(error, 31);
+	} else if constexpr (OP == '-') {
+		result = _mm_sub_epi32(a, b);
+		error = _mm_and_si128(_mm_xor_si128(a, b), _mm_xor_si128(a, result));
+		error = _mm_srai_epi32(error, 31);
+	} else if constexpr (OP == '*') {
+		result = multiplyLow(a, b);
+		error = multiplyOverflow(a, b);
+	} else {
+		__m128i zero = _mm_cmpeq_epi32(b, _mm_setzero_si128());
+		// divide by 1 where the divisor is 0, those lanes are errors anyway
+		__m128i divisor = _mm_sub_epi32(b, zero);
+		__m128i quotient = divide(a, divisor);
+		if constexpr (OP == '/') {
+			__m128i minimum = _mm_cmpeq_epi32(a, _mm_set1_epi32(std::numeric_limits<int>::min()));
+			__m128i minusOne = _mm_cmpeq_epi32(b, _mm_set1_epi32(-1));
+			error = _mm_or_si128(zero, _mm_and_si128(minimum, minusOne));
+			result = quotient;
+		} else {
+			// INT_MIN % -1 wraps to INT_MIN - INT_MIN = 0
+			error = zero;
+			result = _mm_sub_epi32(a, multiplyLow(quotient, divisor));
+		}
+	}
+	_mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_andnot_si128(error, result));
+	return signBits(error);
+}
+
+#endif
+
+template <char OP>
+std::size_t column(int const * lhs, int const * rhs, int * out, std::size_t size, std::uint64_t * errors) {
+	std::size_t errorCount = 0;
+	for (std::size_t start = 0; start < size; start += blockSize) {
+		std::size_t const end = std::min(size, start + blockSize);
+		std::uint64_t bits = 0;
+		std::size_t i = start;
+#if defined(__SSE2__)
+		for (; i + 4 <= end; i += 4) {
+			bits |= kernel<OP>(lhs + i, rhs + i, out + i) << (i - start);
+		}
+#endif
+		for (; i < end; i++) {
+			auto result = tryCalc(lhs[i], rhs[i], OP);
+			out[i] = result.value;
+			bits |= std::uint64_t{!result} << (i - start);
+		}
+		errors[start / blockSize] = bits;
+		errorCount += std::popcount(bits);
+	}
+	return errorCount;
+}
+
+}
+
+std::size_t calc(std::span<int const> lhs, std::span<int const> rhs, char op, std::span<int> out, std::span<std::uint64_t> errors) {
+	std::size_t const size = lhs.size();
+	if (rhs.size() != size || out.size() != size) {
+		throw std::invalid_argument{"Columns of different size!"};
+	}
+	if (errors.size() < errorWords(size)) {
+		throw std::invalid_argument{"Error bitmap too small!"};
+	}
+	switch (op) {
+		case '+':
+			return column<'+'>(lhs.data(), rhs.data(), out.data(), size, errors.data());
+		case '-':
+			return column<'-'>(lhs.data(), rhs.data(), out.data(), size, errors.data());
+		case '*':
+			return column<'*'>(lhs.data(), rhs.data(), out.data(), size, errors.data());
+		case '/':
+			return column<'/'>(lhs.data(), rhs.data(), out.data(), size, errors.data());
+		case '%':
+			return column<'%'>(lhs.data(), rhs.data(), out.data(), size, errors.data());
+		default:
+			throw std::invalid_argument{"Not available operator used."};
+	}
+}
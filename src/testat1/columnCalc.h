@@ -0,0 +1,21 @@
+#ifndef COLUMNCALC
+#define COLUMNCALC
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+// words of the error bitmap of a column with size elements
+constexpr std::size_t errorWords(std::size_t size) {
+	return (size + 63) / 64;
+}
+
+// Column version of calc(lhs, rhs, op): out[i] = calc(lhs[i], rhs[i], op).
+// Where calc would throw, for division or modulo by 0 and overflow, out[i]
+// is 0 and bit i % 64 of errors[i / 64] is set, all other bits are cleared.
+// Returns the number of errors. The columns must have the same size and
+// errors must hold errorWords(size) words, otherwise std::invalid_argument
+// is thrown, like for an unknown operator. Uses SSE2 where available.
+std::size_t calc(std::span<int const> lhs, std::span<int const> rhs, char op, std::span<int> out, std::span<std::uint64_t> errors);
+
+#endif
@@ -0,0 +1,235 @@
+#include "expression.h"
+
+#include <array>
+#include <charconv>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+bool isSpace(char c) {
+	return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+bool isDigit(char c) {
+	return c >= '0' && c <= '9';
+}
+
+bool isNameStart(char c) {
+	return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+bool isNameChar(char c) {
+	return isNameStart(c) || isDigit(c);
+}
+
+// parentheses and unary operators nested deeper are rejected, this bounds
+// the recursion of the compiler
+constexpr int maxNesting = 256;
+
+}
+
+// recursive descent parser emitting postfix code
+class expressionCompiler {
+	using opcode = compiledExpression::opcode;
+
+	compiledExpression & target;
+	char const * position;
+	char const * last;
+	std::size_t depth{0};
+	int nesting{0};
+
+public:
+	expressionCompiler(compiledExpression & target, std::string_view source)
+		: target{target}, position{source.data()}, last{source.data() + source.size()} {}
+
+	void compile() {
+		parseSum();
+		if (peek() != '\0') {
+			fail("Unexpected character in expression!");
+		}
+	}
+
+private:
+	[[noreturn]] static void fail(char const * message) {
+		throw std::invalid_argument{message};
+	}
+
+	// next character after white space, '\0' at the end
+	char peek() {
+		while (position != last && isSpace(*position)) {
+			++position;
+		}
+		return position == last ? '\0' : *position;
+	}
+
+	void emit(opcode code, int operand = 0) {
+		target.code.push_back({code, operand});
+		switch (code) {
+			case opcode::constant:
+			case opcode::variable:
+				if (++depth > compiledExpression::maxStackDepth) {
+					fail("Expression too deeply nested!");
+				}
+				break;
+			case opcode::negate:
+				break;
+			default:
+				--depth;
+		}
+	}
+
+	void parseSum() {
+		parseProduct();
+		for (char op = peek(); op == '+' || op == '-'; op = peek()) {
+			++position;
+			parseProduct();
+			emit(op == '+' ? opcode::add : opcode::subtract);
+		}
+	}
+
+	void parseProduct() {
+		parseUnary();
+		for (char op = peek(); op == '*' || op == '/' || op == '%'; op = peek()) {
+			++position;
+			parseUnary();
+			emit(op == '*' ? opcode::multiply : op == '/' ? opcode::divide : opcode::modulo);
+		}
+	}
+
+	void parseUnary() {
+		char op = peek();
+		if (op != '-' && op != '+') {
+			parsePrimary();
+			return;
+		}
+		++position;
+		if (++nesting > maxNesting) {
+			fail("Expression too deeply nested!");
+		}
+		if (op == '-' && isDigit(peek())) {
+			// folded, so that -2147483648 is a valid literal
+			emit(opcode::constant, static_cast<int>(0u - parseLiteral(std::numeric_limits<int>::max() + 1u)));
+		} else {
+			parseUnary();
+			if (op == '-') {
+				emit(opcode::negate);
+			}
+		}
+		--nesting;
+	}
+
+	void parsePrimary() {
+		char c = peek();
+		if (isDigit(c)) {
+			emit(opcode::constant, static_cast<int>(parseLiteral(std::numeric_limits<int>::max())));
+		} else if (isNameStart(c)) {
+			char const * start = position;
+			while (position != last && isNameChar(*position)) {
+				++position;
+			}
+			emit(opcode::variable, variable(std::string_view(start, position - start)));
+		} else if (c == '(') {
+			++position;
+			if (++nesting > maxNesting) {
+				fail("Expression too deeply nested!");
+			}
+			parseSum();
+			if (peek() != ')') {
+				fail("Missing ) in expression!");
+			}
+			++position;
+			--nesting;
+		} else {
+			fail(c == '\0' ? "Unexpected end of expression!" : "Unexpected character in expression!");
+		}
+	}
+
+	unsigned parseLiteral(unsigned limit) {
+		unsigned value = 0;
+		auto [end, error] = std::from_chars(position, last, value);
+		if (error != std::errc{} || value > limit) {
+			fail("Literal does not fit into an int!");
+		}
+		position = end;
+		return value;
+	}
+
+	int variable(std::string_view name) {
+		std::size_t index = target.variableIndex(name);
+		if (index == target.names.size()) {
+			target.names.emplace_back(name);
+		}
+		return static_cast<int>(index);
+	}
+};
+
+compiledExpression::compiledExpression(std::string_view source) {
+	expressionCompiler{*this, source}.compile();
+	code.shrink_to_fit();
+}
+
+std::size_t compiledExpression::variableIndex(std::string_view name) const {
+	std::size_t index = 0;
+	while (index < names.size() && names[index] != name) {
+		index++;
+	}
+	return index;
+}
+
+calcResult compiledExpression::evaluate(std::span<int const> values) const noexcept {
+	if (values.size() < names.size()) {
+		return {0, calcError::invalidInput};
+	}
+	std::array<int, maxStackDepth> stack;
+	int * top = stack.data();
+	for (auto const & [op, operand] : code) {
+		bool overflow = false;
+		switch (op) {
+			case opcode::constant:
+				*top++ = operand;
+				continue;
+			case opcode::variable:
+				*top++ = values[operand];
+				continue;
+			case opcode::negate:
+				overflow = __builtin_sub_overflow(0, top[-1], &top[-1]);
+				break;
+			case opcode::add:
+				--top;
+				overflow = __builtin_add_overflow(top[-1], top[0], &top[-1]);
+				break;
+			case opcode::subtract:
+				--top;
+				overflow = __builtin_sub_overflow(top[-1], top[0], &top[-1]);
+				break;
+			case opcode::multiply:
+				--top;
+				overflow = __builtin_mul_overflow(top[-1], top[0], &top[-1]);
+				break;
+			case opcode::divide:
+			case opcode::modulo: {
+				--top;
+				auto result = tryCalc(top[-1], top[0], op == opcode::divide ? '/' : '%');
+				if (!result) {
+					return result;
+				}
+				top[-1] = result.value;
+				break;
+			}
+		}
+		if (overflow) {
+			return {0, calcError::overflow};
+		}
+	}
+	return {stack[0], calcError::none};
+}
+
+compiledExpression const & expressionCache::get(std::string_view source) {
+	auto found = expressions.find(source);
+	if (found == expressions.end()) {
+		compiledExpression compiled{source};
+		found = expressions.emplace(std::string{source}, std::move(compiled)).first;
+	}
+	return found->second;
+}
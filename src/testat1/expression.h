@@ -0,0 +1,79 @@
+#ifndef EXPRESSION
+#define EXPRESSION
+
+#include "calc.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// An integer expression compiled once into postfix code and evaluated many
+// times. The source may contain int literals, variables ([A-Za-z_][A-Za-z0-9_]*),
+// parentheses, unary minus and the binary operators of calc, where * / %
+// bind tighter than + -, and all of them associate to the left.
+class compiledExpression {
+public:
+	// deepest evaluation stack an expression may need
+	static constexpr std::size_t maxStackDepth = 64;
+
+	// throws std::invalid_argument if source is not a valid expression
+	explicit compiledExpression(std::string_view source);
+
+	// names of the variables in order of their first occurrence
+	std::vector<std::string> const & variables() const {
+		return names;
+	}
+	// index of name in variables(), variables().size() if it does not occur
+	std::size_t variableIndex(std::string_view name) const;
+
+	// Evaluates with values[i] bound to variables()[i], without allocating.
+	// Reports the errors of tryCalc, and invalidInput if values is too short.
+	calcResult evaluate(std::span<int const> values = {}) const noexcept;
+
+	std::size_t size() const {
+		return code.size();
+	}
+
+private:
+	enum class opcode : std::uint8_t { constant, variable, add, subtract, multiply, divide, modulo, negate };
+	struct instruction {
+		opcode code;
+		int operand;
+	};
+
+	std::vector<instruction> code{};
+	std::vector<std::string> names{};
+
+	friend class expressionCompiler;
+};
+
+// Compiled expressions keyed by their source text. References returned by
+// get stay valid until clear.
+class expressionCache {
+	struct hash {
+		using is_transparent = void;
+		std::size_t operator()(std::string_view source) const {
+			return std::hash<std::string_view>{}(source);
+		}
+	};
+
+	std::unordered_map<std::string, compiledExpression, hash, std::equal_to<>> expressions{};
+
+public:
+	// compiles source on the first request, throws like compiledExpression
+	compiledExpression const & get(std::string_view source);
+
+	std::size_t size() const {
+		return expressions.size();
+	}
+	void clear() {
+		expressions.clear();
+	}
+};
+
+#endif
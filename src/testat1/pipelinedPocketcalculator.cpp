@@ -0,0 +1,186 @@
+#include "pipelinedPocketcalculator.h"
+#include "boundedQueue.h"
+#include "pocketcalculator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t blockSize = 64 * 1024;
+constexpr std::uint64_t endOfInput = std::numeric_limits<std::uint64_t>::max();
+
+// lines to evaluate, or their output, with the position in the input
+struct batch {
+	std::uint64_t sequence{endOfInput};
+	std::string text{};
+};
+
+// the first exception thrown by any stage, rethrown on the calling thread
+class firstError {
+	std::mutex mutex{};
+	std::exception_ptr error{};
+	std::atomic<bool> raised{false};
+
+public:
+	// call in a catch block
+	void capture() {
+		std::lock_guard<std::mutex> lock{mutex};
+		if (!error) {
+			error = std::current_exception();
+		}
+		raised.store(true);
+	}
+	bool failed() const {
+		return raised.load();
+	}
+	void rethrow() {
+		if (error) {
+			std::rethrow_exception(error);
+		}
+	}
+};
+
+// Cuts the input into batches of batchSize lines, counted in sent. Stops
+// early once a stage failed.
+void readBatches(std::istream & is, boundedQueue<batch> & batches, std::size_t batchSize, firstError const & error, std::uint64_t & sent) {
+	std::string input(blockSize, '\0');
+	std::size_t pending = 0;
+	batch current{};
+	std::size_t lines = 0;
+	auto buffer = is.rdbuf();
+	auto send = [&] {
+		current.sequence = sent;
+		batches.push(std::move(current));
+		sent++;
+		current = batch{};
+		lines = 0;
+	};
+	while (!error.failed()) {
+		if (pending == input.size()) {
+			// a line longer than the buffer
+			input.resize(2 * input.size());
+		}
+		auto read = buffer->sgetn(input.data() + pending, input.size() - pending);
+		if (read <= 0) {
+			break;
+		}
+		std::string_view block{input.data(), pending + read};
+		std::size_t start = 0;
+		for (auto end = block.find('\n'); end != std::string_view::npos; end = block.find('\n', end + 1)) {
+			if (++lines == batchSize) {
+				current.text.append(block.substr(start, end + 1 - start));
+				start = end + 1;
+				send();
+			}
+		}
+		// complete lines stay in the current batch, a partial one in input
+		std::size_t complete = block.rfind('\n') + 1;
+		if (complete > start) {
+			current.text.append(block.substr(start, complete - start));
+		}
+		pending = block.size() - std::max(start, complete);
+		std::copy(input.begin() + (block.size() - pending), input.begin() + block.size(), input.begin());
+	}
+	current.text.append(input.data(), pending);
+	if (!current.text.empty()) {
+		send();
+	}
+	is.setstate(std::ios::eofbit);
+}
+
+// A failed batch is still answered, with no output, so the writer does
+// not wait for it.
+void evaluateBatches(boundedQueue<batch> & batches, boundedQueue<batch> & results, firstError & error) {
+	for (batch next = batches.pop(); next.sequence != endOfInput; next = batches.pop()) {
+		batch result{next.sequence, {}};
+		try {
+			evaluateLines(next.text, result.text);
+		} catch (...) {
+			error.capture();
+			result.text.clear();
+		}
+		results.push(std::move(result));
+	}
+}
+
+}
+
+void pipelinedPocketcalculator(std::istream & is, std::ostream & os, pipelineOptions const & options) {
+	unsigned const workers = std::max(options.workers, 1u);
+	std::size_t const batchSize = std::max<std::size_t>(options.batchSize, 1);
+	boundedQueue<batch> batches{options.queueCapacity};
+	boundedQueue<batch> results{options.queueCapacity};
+	std::atomic<std::uint64_t> batchCount{endOfInput};
+	firstError error{};
+
+	std::vector<std::thread> evaluators{};
+	// one end marker per worker, they take no other batch after it
+	auto stopEvaluators = [&] {
+		for (std::size_t i = 0; i < evaluators.size(); i++) {
+			batches.push(batch{});
+		}
+		for (auto & evaluator : evaluators) {
+			evaluator.join();
+		}
+	};
+	std::thread reader{};
+	try {
+		for (unsigned i = 0; i < workers; i++) {
+			evaluators.emplace_back(evaluateBatches, std::ref(batches), std::ref(results), std::ref(error));
+		}
+		reader = std::thread{[&] {
+			std::uint64_t sent = 0;
+			try {
+				readBatches(is, batches, batchSize, error, sent);
+			} catch (...) {
+				error.capture();
+			}
+			batchCount.store(sent);
+			// tells the writer that batchCount is known
+			results.push(batch{});
+		}};
+	} catch (...) {
+		stopEvaluators();
+		throw;
+	}
+
+	// results that overtook an earlier batch wait here
+	std::map<std::uint64_t, std::string> early{};
+	std::uint64_t written = 0;
+	std::uint64_t total = endOfInput;
+	while (written != total) {
+		batch result = results.pop();
+		if (result.sequence == endOfInput) {
+			total = batchCount.load();
+			continue;
+		}
+		early.emplace(result.sequence, std::move(result.text));
+		for (auto next = early.begin(); next != early.end() && next->first == written; next = early.erase(next)) {
+			// after a failure the remaining results are only collected
+			if (!error.failed()) {
+				try {
+					os.write(next->second.data(), next->second.size());
+				} catch (...) {
+					error.capture();
+				}
+			}
+			written++;
+		}
+	}
+
+	reader.join();
+	stopEvaluators();
+	error.rethrow();
+}
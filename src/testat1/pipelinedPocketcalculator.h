@@ -0,0 +1,24 @@
+#ifndef PIPELINEDPOCKETCALC
+#define PIPELINEDPOCKETCALC
+
+#include <cstddef>
+#include <iosfwd>
+
+struct pipelineOptions {
+	// evaluation and render threads, at least 1
+	unsigned workers{4};
+	// lines handed to a worker at once, at least 1
+	std::size_t batchSize{1024};
+	// batches each queue holds, rounded up to a power of two
+	std::size_t queueCapacity{64};
+};
+
+// Same output as batchPocketcalculator, computed by a pipeline. A reader
+// thread cuts the input into batches of lines, the workers evaluate and
+// render them, and the calling thread writes the results in input order.
+// The stages are connected by bounded lock-free queues and block while
+// they have nothing to do. The first exception of any stage, e.g. of a
+// stream with exceptions enabled, stops the pipeline and is rethrown here.
+void pipelinedPocketcalculator(std::istream & in, std::ostream & out, pipelineOptions const & options = {});
+
+#endif
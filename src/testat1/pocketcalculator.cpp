@@ -2,8 +2,11 @@
 #include "pocketcalculator.h"
 #include "sevensegment.h"
 
+#include <algorithm>
 #include <iostream>
 #include <stdexcept>
+#include <string>
+#include <string_view>
 
 void pocketcalculator(std::istream & is, std::ostream & os) {
 	while (is.good()) { //Hier koennte mit std::getline einfach eine Zeile gelesen werden, von welcher man einen neuen istringstream konstrutiert. Dann muesste man den Stream-State nicht explizit veraendern und das return bei peek() ==-1 waere nicht noetig.
@@ -20,6 +23,72 @@ void pocketcalculator(std::istream & is, std::ostream & os) {
 		{
 			printLargeError(os);
 			is.setstate(std::ios::goodbit); //Hier koennte man einfach is.clear() aufrufen. Das goodbit ist quasi kein gesetzter Wert (der Name ist irrefuehrend).
+		} catch (std::overflow_error const &)
+		{
+			// the expression was read completely, the stream is still good
+			printLargeError(os);
+		}
+	}
+}
+
+namespace {
+
+constexpr std::size_t blockSize = 64 * 1024;
+
+bool isBlank(std::string_view line) {
+	return line.find_first_not_of(" \t\n\v\f\r") == std::string_view::npos;
+}
+
+void evaluateLine(std::string_view line, std::string & output) {
+	if (isBlank(line)) {
+		return;
+	}
+	int result = 0;
+	if (calcLine(line, result) == calcError::none) {
+		appendLargeNumber(result, output);
+	} else {
+		appendLargeError(output);
+	}
+}
+
+}
+
+void evaluateLines(std::string_view lines, std::string & output) {
+	std::size_t start = 0;
+	for (auto end = lines.find('\n'); end != std::string_view::npos; end = lines.find('\n', start)) {
+		evaluateLine(lines.substr(start, end - start), output);
+		start = end + 1;
+	}
+	evaluateLine(lines.substr(start), output);
+}
+
+void batchPocketcalculator(std::istream & is, std::ostream & os) {
+	std::string input(blockSize, '\0');
+	std::string output{};
+	output.reserve(2 * blockSize);
+	std::size_t pending = 0;
+	auto buffer = is.rdbuf();
+	while (true) {
+		if (pending == input.size()) {
+			// a line longer than the buffer
+			input.resize(2 * input.size());
+		}
+		auto read = buffer->sgetn(input.data() + pending, input.size() - pending);
+		if (read <= 0) {
+			break;
+		}
+		std::string_view block{input.data(), pending + read};
+		// size of the complete lines, npos + 1 wraps to 0
+		std::size_t complete = block.rfind('\n') + 1;
+		evaluateLines(block.substr(0, complete), output);
+		pending = block.size() - complete;
+		std::copy(input.begin() + complete, input.begin() + complete + pending, input.begin());
+		if (output.size() >= blockSize) {
+			os.write(output.data(), output.size());
+			output.clear();
 		}
 	}
+	evaluateLines(std::string_view{input.data(), pending}, output);
+	os.write(output.data(), output.size());
+	is.setstate(std::ios::eofbit);
 }
@@ -2,7 +2,20 @@
 #define POCKETCALC
 
 #include <iosfwd> //Gut
+#include <string>
+#include <string_view>
 
 void pocketcalculator(std::istream & in, std::ostream & out); //Gut
 
+// Line based pocketcalculator for large inputs. Every line holds one
+// expression and yields one large number or error, lines with only white
+// space are skipped. Unlike pocketcalculator it does not stop at the first
+// invalid line and an expression can not span several lines. The input is
+// read and the output written in large blocks.
+void batchPocketcalculator(std::istream & in, std::ostream & out);
+
+// Appends the output of batchPocketcalculator for the lines of text to
+// output. A last line without newline is evaluated as well.
+void evaluateLines(std::string_view text, std::string & output);
+
 #endif
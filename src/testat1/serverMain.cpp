@@ -0,0 +1,36 @@
+#include "calculatorServer.h"
+
+#include <csignal>
+#include <iostream>
+#include <system_error>
+
+// Runs the pocketcalculator service on the socket given as argument until
+// SIGINT or SIGTERM, e.g.
+// g++ -std=c++20 -O2 serverMain.cpp calculatorServer.cpp pocketcalculator.cpp calc.cpp sevensegment.cpp
+
+namespace {
+
+calculatorServer * running{nullptr};
+
+extern "C" void stopServer(int) {
+	running->stop();
+}
+
+}
+
+int main(int argc, char const *argv[]) {
+	if (argc != 2) {
+		std::cerr << "usage: " << argv[0] << " <socket path>\n";
+		return 2;
+	}
+	try {
+		calculatorServer server{argv[1]};
+		running = &server;
+		std::signal(SIGINT, stopServer);
+		std::signal(SIGTERM, stopServer);
+		server.run();
+	} catch (std::system_error const & e) {
+		std::cerr << e.what() << '\n';
+		return 1;
+	}
+}
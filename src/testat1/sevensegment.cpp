@@ -1,76 +1,119 @@
 #include "sevensegment.h"
+#include <algorithm>
 #include <array>
-#include <vector>
-#include <string>
+#include <cstring>
 #include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
 
-//Die Magic Number 5 koennte man noch extrahieren. Wird weiter unten auch verwendet.
-const std::array<std::string, 5> ZERO{" - ", "| |", "   ", "| |", " - "}; ///Namen die nur aus Grossbuchstaben bestehen, sollten in C++ nicht verwendet werden, da sie ein Praeprozessor-Makro implizieren.
-const std::array<std::string, 5> ONE{"   ", "  |", "   ", "  |", "   "};
-const std::array<std::string, 5> TWO{" - ", "  |", " - ", "|  ", " - "};
-const std::array<std::string, 5> THREE{" - ", "  |", " - ", "  |", " - "};
-const std::array<std::string, 5> FOUR{"   ", "| |", " - ", "  |", "   "};
-const std::array<std::string, 5> FIVE{" - ", "|  ", " - ", "  |", " - "};
-const std::array<std::string, 5> SIX{" - ", "|  ", " - ", "| |", " - "};
-const std::array<std::string, 5> SEVEN{" - ", "  |", "   ", "  |", "   "};
-const std::array<std::string, 5> EIGHT{" - ", "| |", " - ", "| |", " - "};
-const std::array<std::string, 5> NINE{" - ", "| |", " - ", "  |", " - "};
-
-const std::array<std::string, 5> E{" - ", "|  ", " - ", "|  ", " - "};
-const std::array<std::string, 5> R{"   ", "   ", " - ","|  ", "   "};
-const std::array<std::string, 5> O{"   ", "   ", " - ", "| |", " - "};
-const std::array<std::string, 5> MINUS{"   ", "   ", " - ", "   ", "   "};
-
-const std::array<std::array<std::string, 5>, 11> DIGITS{ZERO, ONE,TWO, THREE, FOUR, FIVE, SIX, SEVEN, EIGHT, NINE, MINUS};
-const std::array<std::array<std::string, 5>, 10> ERROR{E, R, R, O, R};
+namespace {
 
-void printLargeDigit(int i, std::ostream & out) {
-	//Die lokale Kopie outString breauchte es nicht. Grundsaetzlich ist aber nichts gegen erklaerende lokale Variablen einzuwenden. outString ist aber kein sehr sprechender name und auch nicht so ganz richtig.
-	std::array<std::string, 5> const outString = DIGITS.at(i);
-		for (auto const & cref : outString){ //Hier haette man den copy-Algorithmus verwenden koennen
-			out << cref << '\n';
-		}
+constexpr std::size_t glyphRows = 5;
+constexpr std::size_t glyphWidth = 3;
+using glyph = std::array<std::string_view, glyphRows>;
+
+// digits 0 to 9 and the minus sign
+constexpr std::array<glyph, 11> digitGlyphs{{
+	{" - ", "| |", "   ", "| |", " - "},
+	{"   ", "  |", "   ", "  |", "   "},
+	{" - ", "  |", " - ", "|  ", " - "},
+	{" - ", "  |", " - ", "  |", " - "},
+	{"   ", "| |", " - ", "  |", "   "},
+	{" - ", "|  ", " - ", "  |", " - "},
+	{" - ", "|  ", " - ", "| |", " - "},
+	{" - ", "  |", "   ", "  |", "   "},
+	{" - ", "| |", " - ", "| |", " - "},
+	{" - ", "| |", " - ", "  |", " - "},
+	{"   ", "   ", " - ", "   ", "   "},
+}};
+constexpr std::size_t minusGlyph = 10;
+constexpr std::array<glyph, 3> errorLetters{{
+	{" - ", "|  ", " - ", "|  ", " - "},
+	{"   ", "   ", " - ", "|  ", "   "},
+	{"   ", "   ", " - ", "| |", " - "},
+}};
+// E R R O R
+constexpr std::array<unsigned char, 5> errorIndices{0, 1, 1, 2, 1};
+
+static_assert(glyphRows * ((1 + 10) * glyphWidth + 1) == maxRenderedSize);
+
+// indices into digitGlyphs, most significant first, returns the count
+std::size_t glyphIndices(int number, std::array<unsigned char, 11> & indices) {
+	// the magnitude as unsigned, so that INT_MIN needs no negation
+	unsigned magnitude = number < 0 ? 0u - static_cast<unsigned>(number) : number;
+	std::size_t count = 0;
+	do {
+		indices[count++] = magnitude % 10;
+		magnitude /= 10;
+	} while (magnitude != 0);
+	if (number < 0) {
+		indices[count++] = minusGlyph;
+	}
+	std::reverse(indices.begin(), indices.begin() + count);
+	return count;
 }
 
-//Tipp: Dies koennte etwas einfacher mit std::to_stirng geloest werden.
-void splitNumber(std::vector<int> & digits, int number){ //Statt digits ueber einen Seiteneffekt zu veraendern, waere es besser den digits-Vector nicht als Parameter zu nehmen, sondern einfach einen neuen digits-Vector zurueckzugeben (per value).
-	if(number > 9){
-		splitNumber(digits, (number/10));
+std::size_t render(std::span<glyph const> glyphs, std::span<unsigned char const> indices, std::span<char, maxRenderedSize> buffer) {
+	char * position = buffer.data();
+	for (std::size_t row = 0; row < glyphRows; row++) {
+		for (unsigned char index : indices) {
+			std::memcpy(position, glyphs[index][row].data(), glyphWidth);
+			position += glyphWidth;
+		}
+		*position++ = '\n';
 	}
-	digits.push_back(number%10);
+	return position - buffer.data();
 }
 
-void printLargeNumber(int number, std::ostream & out){
-	std::vector<int> digits{}; //Variablen erst vor der ersten Verwendung deklarieren. Bzw. im Fall von digits besser direkt mit dem splitNumber-Call zusammenfassen (siehe Kommentar oben)
-	bool negative = false;
+}
 
-	if(number < 0){
-		negative = true;
-		number *= -1;
-	}
-	splitNumber(digits, number);
+std::size_t renderLargeNumber(int number, std::span<char, maxRenderedSize> buffer) {
+	std::array<unsigned char, 11> indices;
+	std::size_t count = glyphIndices(number, indices);
+	return render(digitGlyphs, std::span{indices.data(), count}, buffer);
+}
 
-	for (int i = 0; i<5;i++)
-	{
-		if(negative){
-			out << MINUS[i];
-		}
+std::size_t renderLargeError(std::span<char, maxRenderedSize> buffer) {
+	return render(errorLetters, errorIndices, buffer);
+}
 
-		for (int const digit : digits)
-		{
-			out << DIGITS[digit][i];
-		}
-			out << '\n'; //Einrueckung
+void printLargeDigit(int i, std::ostream & out) {
+	if (i < 0 || i > static_cast<int>(minusGlyph)) {
+		throw std::out_of_range("Index out of bound exception!");
 	}
+	std::array<char, maxRenderedSize> buffer;
+	unsigned char const index = i;
+	out.write(buffer.data(), render(digitGlyphs, std::span{&index, 1}, buffer));
 }
 
-void printLargeError(std::ostream &out){
-	for (int i = 0; i<5; i++){
-		for(auto const & cref : ERROR){
-			out << cref[i];
-		}
-		out << '\n';
-	}
+void printLargeNumber(int number, std::ostream & out) {
+	std::array<char, maxRenderedSize> buffer;
+	out.write(buffer.data(), renderLargeNumber(number, buffer));
 }
 
-//Gute Loesung
+void printLargeError(std::ostream & out) {
+	std::array<char, maxRenderedSize> buffer;
+	out.write(buffer.data(), renderLargeError(buffer));
+}
+
+std::size_t largeNumberWidth(int number) {
+	std::array<unsigned char, 11> indices;
+	return glyphIndices(number, indices);
+}
+
+void printLargeNumber(int number, std::ostream & out, std::size_t displayWidth) {
+	std::array<char, maxRenderedSize> buffer;
+	std::size_t size = largeNumberWidth(number) > displayWidth ? renderLargeError(buffer) : renderLargeNumber(number, buffer);
+	out.write(buffer.data(), size);
+}
+
+void appendLargeNumber(int number, std::string & out) {
+	std::array<char, maxRenderedSize> buffer;
+	out.append(buffer.data(), renderLargeNumber(number, buffer));
+}
+
+void appendLargeError(std::string & out) {
+	std::array<char, maxRenderedSize> buffer;
+	out.append(buffer.data(), renderLargeError(buffer));
+}
@@ -0,0 +1,35 @@
+#ifndef SEVENSEGMENT
+#define SEVENSEGMENT
+
+#include <cstddef>
+#include <iosfwd>
+#include <span>
+#include <string>
+
+// The large displays are rendered into a stack buffer and written with a
+// single call. printLargeDigit prints the digit i, or the minus sign for
+// 10, and throws std::out_of_range for anything else.
+void printLargeDigit(int i, std::ostream & out);
+void printLargeNumber(int number, std::ostream & out);
+void printLargeError(std::ostream & out);
+
+// same output as printLargeNumber/printLargeError, appended to out
+void appendLargeNumber(int number, std::string & out);
+void appendLargeError(std::string & out);
+
+// five rows of a minus sign and ten digits, three characters each, plus newlines
+constexpr std::size_t maxRenderedSize = 5 * (11 * 3 + 1);
+
+// Render the output of printLargeNumber/printLargeError into buffer without
+// allocating and return the number of characters written.
+std::size_t renderLargeNumber(int number, std::span<char, maxRenderedSize> buffer);
+std::size_t renderLargeError(std::span<char, maxRenderedSize> buffer);
+
+// number of glyphs printLargeNumber needs for number, the minus included
+std::size_t largeNumberWidth(int number);
+
+// Like printLargeNumber, but prints the error if number needs more than
+// displayWidth glyphs. The output is written with a single call.
+void printLargeNumber(int number, std::ostream & out, std::size_t displayWidth);
+
+#endif
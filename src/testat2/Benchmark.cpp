@@ -0,0 +1,445 @@
+#include "kwic.h"
+#include "kwicIndex.h"
+#include "stopWords.h"
+#include "tokenizer.h"
+#include "utf8.h"
+#include "wordPool.h"
+#include "rotation.h"
+#include "rotationSort.h"
+#include "rotationWriter.h"
+#include "word.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Micro benchmarks for Word, the tokenizer and kwic. Build with
+// optimisation, e.g.
+// g++ -std=c++20 -O2 -pthread Benchmark.cpp word.cpp kwic.cpp kwicIndex.cpp topKwic.cpp
+// stopWords.cpp rotation.cpp externalKwic.cpp
+// rotationSort.cpp rotationWriter.cpp wordPool.cpp utf8.cpp unicodeTables.cpp
+// and pass the number of words as the first argument.
+
+using text::Word;
+
+namespace {
+
+template <typename FUNCTION>
+double measure(FUNCTION && function) {
+	auto start = std::chrono::steady_clock::now();
+	function();
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	return elapsed.count();
+}
+
+void report(std::string const & name, double milliseconds) {
+	std::cout << std::left << std::setw(48) << name << std::right << std::setw(12) << std::fixed << std::setprecision(2) << milliseconds << " ms\n";
+}
+
+std::vector<std::string> randomWords(std::size_t n, unsigned seed) {
+	std::mt19937 rng{seed};
+	std::uniform_int_distribution<int> length{2, 10};
+	std::uniform_int_distribution<int> letter{0, 51};
+	std::vector<std::string> words(n);
+	for (auto & word : words) {
+		word.resize(length(rng));
+		for (auto & c : word) {
+			int l = letter(rng);
+			c = l < 26 ? 'a' + l : 'A' + l - 26;
+		}
+	}
+	return words;
+}
+
+// the previous Word::operator< lower cased copies of both operands
+std::string toLowerCopy(std::string const & s) {
+	std::string temp = s;
+	for (auto & c : temp) {
+		c = std::tolower(static_cast<unsigned char>(c));
+	}
+	return temp;
+}
+
+void benchmarkWordSort(std::size_t n) {
+	std::cout << "--- sorting " << n << " words ---\n";
+	auto strings = randomWords(n, 1);
+	std::vector<Word> words{};
+	words.reserve(n);
+	for (auto const & s : strings) {
+		words.emplace_back(s);
+	}
+	report("folding per comparison (before)", measure([&] {
+		std::sort(strings.begin(), strings.end(), [](std::string const & lhs, std::string const & rhs) {
+			return toLowerCopy(lhs) < toLowerCopy(rhs);
+		});
+	}));
+	report("Word::operator< with cached key", measure([&] {
+		std::sort(words.begin(), words.end());
+	}));
+}
+
+// a corpus drawn from a small vocabulary, like natural text
+void benchmarkInterning(std::size_t n) {
+	std::cout << "--- sorting " << n << " words from 5000 distinct ones ---\n";
+	auto vocabulary = randomWords(5000, 4);
+	std::vector<std::string> strings(n);
+	std::mt19937 rng{4};
+	for (auto & s : strings) {
+		s = vocabulary[rng() % vocabulary.size()];
+	}
+	std::vector<Word> words{};
+	report("construct Words", measure([&] {
+		words.reserve(n);
+		for (auto const & s : strings) {
+			words.emplace_back(s);
+		}
+	}));
+	report("sort Words", measure([&] {
+		std::sort(words.begin(), words.end());
+	}));
+	text::wordPool pool{};
+	std::vector<std::uint32_t> ranks(n);
+	report("intern folded words and rank them", measure([&] {
+		std::vector<text::wordId> ids(n);
+		std::string folded{};
+		for (std::size_t i = 0; i < n; i++) {
+			folded = toLowerCopy(strings[i]);
+			ids[i] = pool.intern(folded);
+		}
+		auto collation = pool.collationRanks();
+		for (std::size_t i = 0; i < n; i++) {
+			ranks[i] = collation[ids[i]];
+		}
+	}));
+	report("sort ranks", measure([&] {
+		std::sort(ranks.begin(), ranks.end());
+	}));
+	std::size_t wordBytes = n * sizeof(Word);
+	for (auto const & word : words) {
+		if (word.text().size() >= sizeof(std::string)) {
+			wordBytes += 2 * (word.text().size() + 1);
+		}
+	}
+	std::cout << "memory: Words " << wordBytes / 1024 << " KiB, ids " << (n * sizeof(text::wordId) + pool.memoryUsage()) / 1024 << " KiB\n";
+}
+
+std::string randomCorpus(std::size_t words, std::size_t wordsPerLine, unsigned seed) {
+	std::string corpus{};
+	auto vocabulary = randomWords(5000, seed);
+	std::mt19937 rng{seed};
+	for (std::size_t i = 0; i < words; i++) {
+		corpus += vocabulary[rng() % vocabulary.size()];
+		corpus += (i + 1) % wordsPerLine == 0 ? '\n' : ' ';
+	}
+	return corpus;
+}
+
+// the previous operator>>, one peek and one ignore per character
+bool peekingRead(std::istream & is, std::string & word) {
+	while (is.good() && std::isalpha(is.peek()) == 0) {
+		is.ignore();
+	}
+	word.clear();
+	while (is.good() && std::isalpha(is.peek())) {
+		word.push_back(is.get());
+	}
+	return !word.empty();
+}
+
+void reportThroughput(std::string const & name, std::size_t bytes, std::size_t words, double milliseconds) {
+	std::cout << std::left << std::setw(48) << name << std::right << std::setw(12) << std::fixed << std::setprecision(2) << bytes / 1e3 / milliseconds << " MB/s (" << words << " words)\n";
+}
+
+void benchmarkTokenizer(std::size_t n) {
+	auto corpus = randomCorpus(n, 12, 3);
+	std::cout << "--- tokenizing " << corpus.size() / 1000000.0 << " MB ---\n";
+	std::size_t count = 0;
+	double elapsed = measure([&] {
+		std::istringstream input{corpus};
+		std::string word{};
+		while (peekingRead(input, word)) {
+			count++;
+		}
+	});
+	reportThroughput("peek and ignore per character (before)", corpus.size(), count, elapsed);
+	count = 0;
+	elapsed = measure([&] {
+		std::istringstream input{corpus};
+		Word word{};
+		while (input >> word) {
+			count++;
+		}
+	});
+	reportThroughput("operator>>", corpus.size(), count, elapsed);
+	count = 0;
+	elapsed = measure([&] {
+		text::forEachWord(corpus, [&count](std::string_view) {
+			count++;
+		});
+	});
+	reportThroughput("tokenizer", corpus.size(), count, elapsed);
+	count = 0;
+	elapsed = measure([&] {
+		text::forEachWord(corpus, [&count](std::string_view word) {
+			count += Word::fromLetters(word).text().size() != 0;
+		});
+	});
+	reportThroughput("tokenizer and Word::fromLetters", corpus.size(), count, elapsed);
+}
+
+void benchmarkRotationSort(std::size_t maxRotations) {
+	for (std::size_t rotations = 100000; rotations <= maxRotations; rotations *= 10) {
+		std::cout << "--- sorting " << rotations << " rotations, 10 words per line ---\n";
+		auto corpus = randomCorpus(rotations, 10, 5);
+		text::rotationIndex index{};
+		std::string_view rest{corpus};
+		while (!rest.empty()) {
+			std::size_t end = std::min(rest.find('\n'), rest.size());
+			index.addLine(rest.substr(0, end));
+			rest.remove_prefix(std::min(end + 1, rest.size()));
+		}
+		index.sort();
+		auto shuffled = index.sorted();
+		std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937{5});
+		auto compared = shuffled;
+		report("std::sort with rotationLess", measure([&] {
+			text::comparisonSortRotations(index.lines(), compared);
+		}));
+		auto multikey = shuffled;
+		report("multikey quicksort", measure([&] {
+			text::multikeySortRotations(index.lines(), multikey);
+		}));
+	}
+}
+
+void benchmarkKwicIndex(std::size_t words) {
+	std::size_t const wordsPerLine = 10;
+	std::cout << "--- kwicIndex, " << words / wordsPerLine << " lines of " << wordsPerLine << " words ---\n";
+	auto corpus = randomCorpus(words, wordsPerLine, 6);
+	std::vector<std::string_view> lines{};
+	std::string_view rest{corpus};
+	while (!rest.empty()) {
+		std::size_t end = std::min(rest.find('\n'), rest.size());
+		lines.push_back(rest.substr(0, end));
+		rest.remove_prefix(std::min(end + 1, rest.size()));
+	}
+	text::kwicIndex index{};
+	report("addLine, all lines", measure([&] {
+		for (auto line : lines) {
+			index.addLine(line);
+		}
+	}));
+	report("rebuild and sort a rotationIndex once", measure([&] {
+		text::rotationIndex rebuilt{};
+		for (auto line : lines) {
+			rebuilt.addLine(line);
+		}
+		rebuilt.sort();
+	}));
+	auto prefixes = randomWords(10000, 7);
+	std::size_t found = 0;
+	report("10000 lookups of random prefixes", measure([&] {
+		for (auto const & prefix : prefixes) {
+			found += index.lookup(prefix.substr(0, 3)).size();
+		}
+	}));
+	std::cout << found << " rotations found\n";
+}
+
+// the previous output, word by word and flushing every line
+void writeFlushing(std::ostream & os, text::lineStore const & store, text::rotation r) {
+	std::uint32_t length = store.length(r.line);
+	for (std::uint32_t k = 0, position = r.start; k < length; k++) {
+		os << store.text(r.line, position) << " ";
+		if (++position == length) {
+			position = 0;
+		}
+	}
+	os << std::endl;
+}
+
+void benchmarkOutput(std::size_t words) {
+	std::size_t const wordsPerLine = 10;
+	std::cout << "--- writing " << words << " rotations of " << wordsPerLine << " words to a file ---\n";
+	auto corpus = randomCorpus(words, wordsPerLine, 9);
+	text::rotationIndex index{};
+	std::string_view rest{corpus};
+	while (!rest.empty()) {
+		std::size_t end = std::min(rest.find('\n'), rest.size());
+		index.addLine(rest.substr(0, end));
+		rest.remove_prefix(std::min(end + 1, rest.size()));
+	}
+	index.sort();
+	auto path = std::filesystem::temp_directory_path() / "kwicBenchmark.txt";
+	report("operator<< and std::endl (before)", measure([&] {
+		std::ofstream file{path};
+		for (auto r : index.sorted()) {
+			writeFlushing(file, index.lines(), r);
+		}
+	}));
+	report("rotationWriter, buffered", measure([&] {
+		std::ofstream file{path};
+		text::rotationWriter out{file};
+		index.write(out);
+		out.flush();
+	}));
+	report("rotationWriter, writev", measure([&] {
+		std::FILE * file = std::fopen(path.c_str(), "w");
+		text::rotationWriter out{std::cout, fileno(file)};
+		index.write(out);
+		out.flush();
+		std::fclose(file);
+	}));
+	std::filesystem::remove(path);
+}
+
+// the previous kwic that stored a copy of the line for every rotation
+void copyingKwic(std::istream & is, std::ostream & os) {
+	std::vector<std::vector<Word>> inputlines{};
+	while (is.good()) {
+		std::string inputline{};
+		std::getline(is, inputline);
+		std::stringstream ss(inputline);
+		std::vector<Word> line(std::istream_iterator<Word>{ss}, std::istream_iterator<Word>{});
+		for (std::size_t i = 0; i < line.size(); i++) {
+			inputlines.push_back(line);
+			std::rotate(line.begin(), line.begin() + 1, line.end());
+		}
+	}
+	std::sort(inputlines.begin(), inputlines.end());
+	for (auto const & line : inputlines) {
+		for (auto const & word : line) {
+			os << word << " ";
+		}
+		os << '\n';
+	}
+}
+
+template <typename KWIC>
+void runKwic(std::string const & name, std::string const & corpus, KWIC kwic) {
+	report(name, measure([&] {
+		std::istringstream input{corpus};
+		std::ostringstream output{};
+		kwic(input, output);
+	}));
+}
+
+void benchmarkKwic(std::size_t words, std::size_t wordsPerLine) {
+	std::cout << "--- kwic, " << words << " words, " << wordsPerLine << " words per line ---\n";
+	auto corpus = randomCorpus(words, wordsPerLine, 2);
+	runKwic("copy per rotation (before)", corpus, copyingKwic);
+	runKwic("kwic", corpus, [](std::istream & is, std::ostream & os) {
+		text::kwic(is, os);
+	});
+	unsigned threads = std::max(2u, std::thread::hardware_concurrency());
+	runKwic("kwic, threads = " + std::to_string(threads), corpus, [threads](std::istream & is, std::ostream & os) {
+		text::kwic(is, os, text::kwicOptions { threads });
+	});
+	for (std::size_t budget : { corpus.size() * 4, corpus.size() / 4, corpus.size() / 64 }) {
+		runKwic("kwic, memory budget = " + std::to_string(budget >> 10) + " KiB", corpus, [budget](std::istream & is, std::ostream & os) {
+			text::kwic(is, os, text::kwicOptions { 1, budget });
+		});
+	}
+}
+
+void benchmarkTopKwic(std::size_t words) {
+	std::size_t const wordsPerLine = 10;
+	std::cout << "--- kwic with limits, " << words / wordsPerLine << " lines of " << wordsPerLine << " words ---\n";
+	auto corpus = randomCorpus(words, wordsPerLine, 8);
+	runKwic("kwic, everything", corpus, [](std::istream & is, std::ostream & os) {
+		text::kwic(is, os);
+	});
+	auto withOptions = [](std::size_t perKeyword, std::size_t limit) {
+		return [perKeyword, limit](std::istream & is, std::ostream & os) {
+			text::kwicOptions options{};
+			options.stopWords = &text::englishStopWords();
+			options.perKeyword = perKeyword;
+			options.limit = limit;
+			text::kwic(is, os, options);
+		};
+	};
+	runKwic("stop words", corpus, withOptions(0, 0));
+	runKwic("stop words, 3 per keyword", corpus, withOptions(3, 0));
+	runKwic("stop words, first 1000", corpus, withOptions(0, 1000));
+}
+
+
+// words mixing ASCII, Latin-1, Greek and Cyrillic letters
+std::string mixedScriptCorpus(std::size_t words, unsigned seed) {
+	std::vector<std::string> letters{"a", "e", "n", "r", "s", "t", "\u00e9", "\u00fc", "\u00df", "\u00c5",
+		"\u03b1", "\u03a9", "\u03bb", "\u0436", "\u0414", "\u044f"};
+	std::mt19937 rng{seed};
+	std::string corpus{};
+	for (std::size_t i = 0; i < words; i++) {
+		for (int length = 2 + rng() % 8; length > 0; length--) {
+			corpus += letters[rng() % letters.size()];
+		}
+		corpus += (i + 1) % 12 == 0 ? '\n' : ' ';
+	}
+	return corpus;
+}
+
+void benchmarkUtf8(std::size_t n) {
+	auto ascii = randomCorpus(n, 12, 10);
+	auto mixed = mixedScriptCorpus(n, 10);
+	std::cout << "--- UTF-8, " << n << " words ---\n";
+	auto tokenize = [](std::string const & name, std::string const & corpus, text::textEncoding encoding) {
+		std::size_t count = 0;
+		double elapsed = measure([&] {
+			text::forEachWord(corpus, encoding, [&count](std::string_view) {
+				count++;
+			});
+		});
+		reportThroughput(name, corpus.size(), count, elapsed);
+	};
+	tokenize("ASCII corpus, ascii tokenizer", ascii, text::textEncoding::ascii);
+	tokenize("ASCII corpus, utf8 tokenizer", ascii, text::textEncoding::utf8);
+	tokenize("mixed corpus, utf8 tokenizer", mixed, text::textEncoding::utf8);
+	auto fold = [](std::string const & name, std::string const & corpus, text::textEncoding encoding) {
+		std::string folded{};
+		folded.reserve(corpus.size());
+		double elapsed = measure([&] {
+			text::foldCase(corpus, encoding, folded);
+		});
+		reportThroughput(name, corpus.size(), 0, elapsed);
+	};
+	fold("ASCII corpus, ascii folding", ascii, text::textEncoding::ascii);
+	fold("ASCII corpus, utf8 folding", ascii, text::textEncoding::utf8);
+	fold("mixed corpus, utf8 folding", mixed, text::textEncoding::utf8);
+	auto kwicWith = [](text::textEncoding encoding) {
+		return [encoding](std::istream & is, std::ostream & os) {
+			text::kwicOptions options{};
+			options.encoding = encoding;
+			text::kwic(is, os, options);
+		};
+	};
+	runKwic("kwic, ASCII corpus, ascii", ascii, kwicWith(text::textEncoding::ascii));
+	runKwic("kwic, ASCII corpus, utf8", ascii, kwicWith(text::textEncoding::utf8));
+	runKwic("kwic, mixed corpus, utf8", mixed, kwicWith(text::textEncoding::utf8));
+}
+}
+
+int main(int argc, char const *argv[]) {
+	std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+	benchmarkWordSort(n);
+	benchmarkInterning(n);
+	benchmarkTokenizer(n);
+	benchmarkRotationSort(10 * n);
+	benchmarkOutput(n);
+	benchmarkKwic(n / 20, 100);
+	benchmarkTopKwic(n);
+	benchmarkUtf8(n);
+	benchmarkKwicIndex(n);
+}
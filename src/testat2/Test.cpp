@@ -1,5 +1,12 @@
 #include "word.h"
 #include "kwic.h"
+#include "tokenizer.h"
+#include "wordPool.h"
+#include "rotation.h"
+#include "rotationSort.h"
+#include "kwicIndex.h"
+#include "stopWords.h"
+#include "utf8.h"
 #include "cute.h"
 #include "ide_listener.h"
 #include "xml_listener.h"
@@ -7,10 +14,18 @@
 #include "iostream"
 #include "stdexcept"
 
+#include <algorithm>
+#include <cctype>
+#include <random>
+#include <cstdio>
 #include <sstream>
 
 using text::Word;
 using text::kwic;
+using text::kwicOptions;
+using text::tokenizer;
+using text::wordPool;
+using text::textEncoding;
 
 
 // Test are written with D.H.
@@ -187,6 +202,403 @@ void test_exercise_example() {
 	ASSERT_EQUAL(Word{"put"}, w);
 }
 
+void test_read_word_compares_case_insensitive() {
+	std::istringstream input{"hAsKeLl"};
+	Word w{};
+	input >> w;
+	ASSERT_EQUAL(Word{"Haskell"}, w);
+	ASSERT_LESS(Word{"Fortran"}, w);
+}
+
+//---------- Tests for class tokenizer ----------
+
+void test_tokenizer_splits_exercise_example() {
+	tokenizer words{"compl33tely ~ weird !!??!! 4matted in_put"};
+	std::string found{};
+	std::string_view word{};
+	while (words.next(word)) {
+		found += word;
+		found += '|';
+	}
+	ASSERT_EQUAL("compl|tely|weird|matted|in|put|", found);
+}
+
+void test_tokenizer_on_buffer_without_words() {
+	tokenizer words{" 42 !\n"};
+	std::string_view word{};
+	ASSERT(!words.next(word));
+}
+
+void test_tokenizer_words_point_into_buffer() {
+	std::string const text{"  ab cd"};
+	tokenizer words{text};
+	std::string_view word{};
+	words.next(word);
+	ASSERT_EQUAL(text.data() + 2, word.data());
+	ASSERT_EQUAL(" cd", std::string{words.rest()});
+}
+
+void test_tokenizer_ignores_non_ascii_bytes() {
+	tokenizer words{"caf\xc3\xa9s"};
+	std::string_view word{};
+	words.next(word);
+	ASSERT_EQUAL("caf", std::string{word});
+	words.next(word);
+	ASSERT_EQUAL("s", std::string{word});
+}
+
+//---------- Tests for class wordPool ----------
+
+void test_word_pool_interns_once() {
+	wordPool pool{};
+	auto first = pool.intern("kotlin");
+	auto other = pool.intern("rust");
+	ASSERT_EQUAL(first, pool.intern(std::string{"kotlin"}));
+	ASSERT_NOT_EQUAL_TO(first, other);
+	ASSERT_EQUAL(2u, pool.size());
+	ASSERT_EQUAL("rust", std::string{pool[other]});
+}
+
+void test_word_pool_ranks_in_byte_order() {
+	wordPool pool{};
+	auto c = pool.intern("c");
+	auto ab = pool.intern("ab");
+	auto a = pool.intern("a");
+	auto ranks = pool.collationRanks();
+	ASSERT_EQUAL(0u, ranks[a]);
+	ASSERT_EQUAL(1u, ranks[ab]);
+	ASSERT_EQUAL(2u, ranks[c]);
+}
+
+void test_word_pool_views_stay_valid() {
+	wordPool pool{};
+	auto first = pool.intern("first");
+	std::string_view view = pool[first];
+	for (int i = 0; i < 100000; i++) {
+		pool.intern(std::to_string(i));
+	}
+	pool.intern(std::string(100000, 'x'));
+	wordPool moved{std::move(pool)};
+	ASSERT_EQUAL(view.data(), moved[first].data());
+	ASSERT_EQUAL("first", std::string{moved[first]});
+}
+
+//---------- Tests for the rotation sorts ----------
+
+text::rotationIndex randomIndex(unsigned seed, int lines) {
+	char const * words[] = {"a", "A", "b", "ab", "Ab", "abc", "the", "The", "zebra"};
+	std::mt19937 rng{seed};
+	text::rotationIndex index{};
+	for (int i = 0; i < lines; i++) {
+		std::string line{};
+		for (unsigned w = rng() % 7; w > 0; w--) {
+			line += words[rng() % 9];
+			line += ' ';
+		}
+		index.addLine(line);
+	}
+	index.sort();
+	return index;
+}
+
+void test_multikey_sort_equals_comparison_sort() {
+	for (unsigned seed : {1u, 2u, 3u}) {
+		auto index = randomIndex(seed, 2000);
+		// sort uses the multikey sort for this many rotations
+		auto expected = index.sorted();
+		std::shuffle(expected.begin(), expected.end(), std::mt19937{seed});
+		auto rotations = expected;
+		text::comparisonSortRotations(index.lines(), expected);
+		text::multikeySortRotations(index.lines(), rotations);
+		ASSERT(std::equal(expected.begin(), expected.end(), rotations.begin(), rotations.end(), [](auto lhs, auto rhs) {
+			return lhs.line == rhs.line && lhs.start == rhs.start;
+		}));
+	}
+}
+
+void test_sorts_agree_on_repeated_lines() {
+	text::rotationIndex index{};
+	for (int i = 0; i < 500; i++) {
+		index.addLine("a b a b");
+		index.addLine("b a");
+	}
+	index.sort();
+	auto compared = index.sorted();
+	auto multikey = compared;
+	std::reverse(compared.begin(), compared.end());
+	std::reverse(multikey.begin(), multikey.end());
+	text::comparisonSortRotations(index.lines(), compared);
+	text::multikeySortRotations(index.lines(), multikey);
+	ASSERT(std::equal(compared.begin(), compared.end(), multikey.begin(), multikey.end(), [](auto lhs, auto rhs) {
+		return lhs.line == rhs.line && lhs.start == rhs.start;
+	}));
+}
+
+//---------- Tests for class kwicIndex ----------
+
+std::vector<std::string> texts(text::kwicIndex const & index, std::vector<text::rotation> const & rotations) {
+	std::vector<std::string> result{};
+	for (auto r : rotations) {
+		result.push_back(index.text(r));
+	}
+	return result;
+}
+
+void test_kwic_index_writes_like_kwic() {
+	std::string const text{"this is a test\n"
+						   "This is another TEST\n"
+						   "\n"
+						   "a b c d\n"
+						   "a a b\n"
+						   "b b c\n"
+						   "Test this\n"
+						   "is A test this"};
+	std::istringstream input{text};
+	std::ostringstream expected{};
+	kwic(input, expected);
+	text::kwicIndex index{};
+	std::istringstream lines{text};
+	std::ostringstream output{};
+	for (std::string line{}; std::getline(lines, line);) {
+		index.addLine(line);
+	}
+	index.write(output);
+	ASSERT_EQUAL(expected.str(), output.str());
+	ASSERT_EQUAL(24u, index.size());
+}
+
+void test_kwic_index_lookup_prefix() {
+	text::kwicIndex index{};
+	index.addLine("this is a test");
+	index.addLine("Testing is fun");
+	index.addLine("a tester");
+	std::vector<std::string> expected{"test this is a ", "tester a ", "Testing is fun "};
+	ASSERT_EQUAL(expected, texts(index, index.lookup("TEST")));
+	std::vector<std::string> words{"test this is a "};
+	ASSERT_EQUAL(words, texts(index, index.lookup("test th")));
+	ASSERT(index.lookup("test x").empty());
+}
+
+void test_kwic_index_lookup_between_additions() {
+	text::kwicIndex index{};
+	index.addLine("b a");
+	ASSERT_EQUAL(1u, index.lookup("a").size());
+	index.addLine("a c");
+	index.addLine("c d e f a");
+	std::vector<std::string> expected{"a b ", "a c ", "a c d e f "};
+	ASSERT_EQUAL(expected, texts(index, index.lookup("a")));
+}
+
+void test_kwic_index_range() {
+	text::kwicIndex index{};
+	index.addLine("alpha beta gamma");
+	index.addLine("delta");
+	std::vector<std::string> expected{"beta gamma alpha ", "delta "};
+	ASSERT_EQUAL(expected, texts(index, index.range("b", "delta x")));
+	ASSERT(index.range("z", "a").empty());
+}
+
+//---------- Tests for stop words and limits ----------
+
+void test_stop_word_set_contains() {
+	text::stopWordSet words{"The", "of", "a"};
+	ASSERT_EQUAL(3u, words.size());
+	ASSERT(words.contains("the"));
+	ASSERT(words.contains("a"));
+	ASSERT(!words.contains("then"));
+	ASSERT(!words.contains(""));
+	ASSERT(!text::stopWordSet{}.contains("a"));
+}
+
+void test_stop_word_set_finds_all_english_stop_words() {
+	auto const & words = text::englishStopWords();
+	for (std::string_view word : {"a", "the", "of", "yourselves", "between", "i"}) {
+		ASSERT(words.contains(word));
+	}
+	ASSERT(!words.contains("kotlin"));
+}
+
+void test_kwic_skips_stop_words() {
+	std::istringstream input{"this is a test"};
+	std::ostringstream output{};
+	kwicOptions options{};
+	options.stopWords = &text::englishStopWords();
+	kwic(input, output, options);
+	ASSERT_EQUAL("test this is a \n", output.str());
+}
+
+// filters the complete output of kwic like the options
+std::string filtered(std::string const & all, text::stopWordSet const * stopWords, std::size_t perKeyword, std::size_t limit) {
+	std::istringstream lines{all};
+	std::string result{};
+	std::string previous{};
+	std::size_t sameKeyword = 0;
+	std::size_t written = 0;
+	for (std::string line{}; std::getline(lines, line);) {
+		std::string keyword = line.substr(0, line.find(' '));
+		std::transform(keyword.begin(), keyword.end(), keyword.begin(), [](unsigned char c) {
+			return std::tolower(c);
+		});
+		if (stopWords && stopWords->contains(keyword)) {
+			continue;
+		}
+		sameKeyword = keyword == previous ? sameKeyword + 1 : 1;
+		previous = keyword;
+		if ((perKeyword == 0 || sameKeyword <= perKeyword) && (limit == 0 || written < limit)) {
+			result += line + '\n';
+			written++;
+		}
+	}
+	return result;
+}
+
+void test_kwic_limits_match_filtered_output() {
+	char const * words[] = {"a", "A", "b", "of", "ab", "The", "the", "zebra", "Zebra", "c"};
+	std::mt19937 rng{9};
+	std::string text{};
+	for (int i = 0; i < 30000; i++) {
+		for (unsigned w = rng() % 6; w > 0; w--) {
+			text += words[rng() % 10];
+			text += ' ';
+		}
+		text += '\n';
+	}
+	std::istringstream allInput{text};
+	std::ostringstream all{};
+	kwic(allInput, all);
+	for (auto stopWords : {static_cast<text::stopWordSet const *>(nullptr), &text::englishStopWords()}) {
+		for (std::size_t perKeyword : {0u, 3u, 100000u}) {
+			for (std::size_t limit : {0u, 5u, 2000u}) {
+				std::istringstream input{text};
+				std::ostringstream output{};
+				kwicOptions options{};
+				options.stopWords = stopWords;
+				options.perKeyword = perKeyword;
+				options.limit = limit;
+				kwic(input, output, options);
+				ASSERT_EQUAL(filtered(all.str(), stopWords, perKeyword, limit), output.str());
+			}
+		}
+	}
+}
+
+//---------- Tests for the output stage ----------
+
+// the output kwic writes to a temporary file with writev
+std::string vectoredKwic(std::string const & text, kwicOptions options) {
+	std::FILE * file = std::tmpfile();
+	std::istringstream input{text};
+	std::ostringstream unused{};
+	options.outputDescriptor = fileno(file);
+	kwic(input, unused, options);
+	std::string written{};
+	std::rewind(file);
+	char block[4096];
+	for (std::size_t n; (n = std::fread(block, 1, sizeof(block), file)) != 0;) {
+		written.append(block, n);
+	}
+	std::fclose(file);
+	ASSERT_EQUAL("", unused.str());
+	return written;
+}
+
+void test_vectored_output_equals_buffered_output() {
+	std::string text{};
+	for (int i = 0; i < 3000; i++) {
+		text += "line number " + std::string(i % 26 + 1, 'a' + i % 26) + " of the input\n";
+	}
+	std::istringstream input{text};
+	std::ostringstream output{};
+	kwic(input, output);
+	ASSERT_EQUAL(output.str(), vectoredKwic(text, kwicOptions{}));
+	ASSERT_EQUAL(output.str(), vectoredKwic(text, kwicOptions{1, 1000}));
+}
+
+void test_output_of_lines_longer_than_the_buffer() {
+	std::string const longWord(100000, 'x');
+	std::string const text{"b " + longWord + "\na"};
+	std::istringstream input{text};
+	std::ostringstream output{};
+	kwic(input, output);
+	ASSERT_EQUAL("a \nb " + longWord + " \n" + longWord + " b \n", output.str());
+	ASSERT_EQUAL(output.str(), vectoredKwic(text, kwicOptions{}));
+	ASSERT_EQUAL(output.str(), vectoredKwic(text, kwicOptions{1, 10}));
+}
+
+//---------- Tests for UTF-8 ----------
+
+std::vector<std::string> utf8Words(std::string const & text) {
+	std::vector<std::string> words{};
+	text::forEachWord(text, textEncoding::utf8, [&words](std::string_view word) {
+		words.emplace_back(word);
+	});
+	return words;
+}
+
+void test_utf8_tokenizer_keeps_accented_words() {
+	std::vector<std::string> expected{"na\u00efve", "caf\u00e9", "\u0395\u03bb\u03bb\u03ac\u03b4\u03b1", "stra\u00dfe"};
+	ASSERT_EQUAL(expected, utf8Words("na\u00efve caf\u00e9, \u0395\u03bb\u03bb\u03ac\u03b4\u03b1 42 stra\u00dfe!"));
+}
+
+void test_utf8_tokenizer_keeps_combining_marks() {
+	std::vector<std::string> expected{"cafe\u0301s"};
+	ASSERT_EQUAL(expected, utf8Words(" cafe\u0301s "));
+}
+
+void test_utf8_tokenizer_splits_at_invalid_bytes_and_punctuation() {
+	std::vector<std::string> expected{"ab", "cd", "ef"};
+	ASSERT_EQUAL(expected, utf8Words("ab\xff""cd\u00bb\u2014ef\xc3"));
+}
+
+void test_utf8_tokenizer_on_long_ascii_text() {
+	std::string text{};
+	for (int i = 0; i < 100; i++) {
+		text += "plain ascii words ";
+	}
+	text += "\u00e9t\u00e9";
+	auto words = utf8Words(text);
+	ASSERT_EQUAL(301u, words.size());
+	ASSERT_EQUAL("\u00e9t\u00e9", words.back());
+}
+
+void test_fold_case_utf8() {
+	std::string folded{};
+	text::foldCase("\u00c0\u00c9\u00ce \u03a3\u0391\u03a3 Stra\u00dfe \u1e9e \u0416", textEncoding::utf8, folded);
+	ASSERT_EQUAL("\u00e0\u00e9\u00ee \u03c3\u03b1\u03c3 stra\u00dfe \u00df \u0436", folded);
+}
+
+void test_utf8_words_compare_case_insensitive() {
+	ASSERT_EQUAL(Word("\u00c4rger", textEncoding::utf8), Word("\u00e4rger", textEncoding::utf8));
+	ASSERT_LESS(Word("zebra", textEncoding::utf8), Word("\u00c4rger", textEncoding::utf8));
+	ASSERT_THROWS(Word("\u00e4 b", textEncoding::utf8), std::invalid_argument);
+	ASSERT_THROWS(Word("\u00e4rger", textEncoding::ascii), std::invalid_argument);
+}
+
+void test_kwic_in_utf8_mode() {
+	std::istringstream input{"\u00dcber alles\n\u00fcben ist"};
+	std::ostringstream output{};
+	kwicOptions options{};
+	options.encoding = textEncoding::utf8;
+	kwic(input, output, options);
+	ASSERT_EQUAL("alles \u00dcber \n"
+				 "ist \u00fcben \n"
+				 "\u00fcben ist \n"
+				 "\u00dcber alles \n", output.str());
+}
+
+void test_kwic_utf8_mode_equals_ascii_mode_on_ascii_input() {
+	std::string const text{"this is a test\nThis is another TEST\na b c d"};
+	std::istringstream asciiInput{text};
+	std::ostringstream asciiOutput{};
+	kwic(asciiInput, asciiOutput);
+	std::istringstream input{text};
+	std::ostringstream output{};
+	kwicOptions options{};
+	options.encoding = textEncoding::utf8;
+	kwic(input, output, options);
+	ASSERT_EQUAL(asciiOutput.str(), output.str());
+}
+
 //---------- Tests for function kwic ----------
 
 void test_single_word_input() {
@@ -240,7 +652,96 @@ void test_multiple_lines_input() {
 }
 
 
-
+void test_long_line_rotations() {
+	std::istringstream input{"e d c b a"};
+	std::ostringstream output{};
+	kwic(input, output);
+	ASSERT_EQUAL("a e d c b \n"
+				 "b a e d c \n"
+				 "c b a e d \n"
+				 "d c b a e \n"
+				 "e d c b a \n", output.str());
+}
+
+void test_equal_rotations_keep_input_order() {
+	std::istringstream input{"b A\n"
+							 "B a\n"
+							 "\n"
+							 "b a"};
+	std::ostringstream output{};
+	kwic(input, output);
+	ASSERT_EQUAL("A b \n"
+				 "a B \n"
+				 "a b \n"
+				 "b A \n"
+				 "B a \n"
+				 "b a \n", output.str());
+}
+void test_parallel_kwic_matches_serial() {
+	std::string const text{"this is a test\n"
+						   "This is another TEST\n"
+						   "\n"
+						   "a b c d\n"
+						   "a a b\n"
+						   "b b c\n"
+						   "Test this\n"
+						   "is A test this"};
+	std::istringstream serialInput{text};
+	std::ostringstream serialOutput{};
+	kwic(serialInput, serialOutput);
+	for (unsigned threads : {2u, 3u, 8u, 20u}) {
+		std::istringstream input{text};
+		std::ostringstream output{};
+		kwic(input, output, kwicOptions{threads});
+		ASSERT_EQUAL(serialOutput.str(), output.str());
+	}
+}
+
+void test_parallel_kwic_on_empty_input() {
+	std::istringstream input{};
+	std::ostringstream output{};
+	kwic(input, output, kwicOptions{4});
+	ASSERT_EQUAL("", output.str());
+}
+
+
+void test_external_kwic_matches_serial() {
+	std::string const text{"this is a test\n"
+						   "This is another TEST\n"
+						   "\n"
+						   "a b c d\n"
+						   "a a b\n"
+						   "b b c\n"
+						   "Test this\n"
+						   "is A test this"};
+	std::istringstream serialInput{text};
+	std::ostringstream serialOutput{};
+	kwic(serialInput, serialOutput);
+	for (std::size_t budget : {1u, 100u, 1000000u}) {
+		std::istringstream input{text};
+		std::ostringstream output{};
+		kwic(input, output, kwicOptions{1, budget});
+		ASSERT_EQUAL(serialOutput.str(), output.str());
+	}
+}
+
+void test_external_kwic_merges_in_several_passes() {
+	std::string text{};
+	for (int i = 0; i < 300; i++) {
+		text += "line ";
+		text += static_cast<char>('a' + i % 26);
+		text += " same ";
+		text += static_cast<char>('z' - i % 7);
+		text += '\n';
+	}
+	std::istringstream serialInput{text};
+	std::ostringstream serialOutput{};
+	kwic(serialInput, serialOutput);
+	std::istringstream input{text};
+	std::ostringstream output{};
+	kwic(input, output, kwicOptions{1, 1});
+	ASSERT_EQUAL(serialOutput.str(), output.str());
+}
 
 bool runAllTests(int argc, char const *argv[]) {
   cute::suite s { };
@@ -275,10 +776,44 @@ bool runAllTests(int argc, char const *argv[]) {
 	s.push_back(CUTE(test_input_operator_overwrites_word));
 	s.push_back(CUTE(test_input_operator_on_stream_without_word));
 	s.push_back(CUTE(test_exercise_example));
+	s.push_back(CUTE(test_read_word_compares_case_insensitive));
+	s.push_back(CUTE(test_tokenizer_splits_exercise_example));
+	s.push_back(CUTE(test_tokenizer_on_buffer_without_words));
+	s.push_back(CUTE(test_tokenizer_words_point_into_buffer));
+	s.push_back(CUTE(test_tokenizer_ignores_non_ascii_bytes));
+	s.push_back(CUTE(test_word_pool_interns_once));
+	s.push_back(CUTE(test_word_pool_ranks_in_byte_order));
+	s.push_back(CUTE(test_word_pool_views_stay_valid));
+	s.push_back(CUTE(test_multikey_sort_equals_comparison_sort));
+	s.push_back(CUTE(test_sorts_agree_on_repeated_lines));
+	s.push_back(CUTE(test_kwic_index_writes_like_kwic));
+	s.push_back(CUTE(test_kwic_index_lookup_prefix));
+	s.push_back(CUTE(test_kwic_index_lookup_between_additions));
+	s.push_back(CUTE(test_kwic_index_range));
+	s.push_back(CUTE(test_stop_word_set_contains));
+	s.push_back(CUTE(test_stop_word_set_finds_all_english_stop_words));
+	s.push_back(CUTE(test_kwic_skips_stop_words));
+	s.push_back(CUTE(test_kwic_limits_match_filtered_output));
+	s.push_back(CUTE(test_vectored_output_equals_buffered_output));
+	s.push_back(CUTE(test_output_of_lines_longer_than_the_buffer));
+	s.push_back(CUTE(test_utf8_tokenizer_keeps_accented_words));
+	s.push_back(CUTE(test_utf8_tokenizer_keeps_combining_marks));
+	s.push_back(CUTE(test_utf8_tokenizer_splits_at_invalid_bytes_and_punctuation));
+	s.push_back(CUTE(test_utf8_tokenizer_on_long_ascii_text));
+	s.push_back(CUTE(test_fold_case_utf8));
+	s.push_back(CUTE(test_utf8_words_compare_case_insensitive));
+	s.push_back(CUTE(test_kwic_in_utf8_mode));
+	s.push_back(CUTE(test_kwic_utf8_mode_equals_ascii_mode_on_ascii_input));
 	s.push_back(CUTE(test_single_word_input));
 	s.push_back(CUTE(test_multiple_words_input));
 	s.push_back(CUTE(test_two_lines_input));
 	s.push_back(CUTE(test_multiple_lines_input));
+	s.push_back(CUTE(test_long_line_rotations));
+	s.push_back(CUTE(test_equal_rotations_keep_input_order));
+	s.push_back(CUTE(test_parallel_kwic_matches_serial));
+	s.push_back(CUTE(test_parallel_kwic_on_empty_input));
+	s.push_back(CUTE(test_external_kwic_matches_serial));
+	s.push_back(CUTE(test_external_kwic_merges_in_several_passes));
 
   cute::xml_file_opener xmlfile(argc, argv);
   cute::xml_listener<cute::ide_listener<>> lis(xmlfile.out);
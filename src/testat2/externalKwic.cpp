@@ -0,0 +1,252 @@
+#include "externalKwic.h"
+#include "rotation.h"
+#include "rotationWriter.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <istream>
+#include <memory>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace text {
+
+namespace {
+
+constexpr std::size_t readBlockSize = 1 << 20;
+constexpr std::size_t minimumRunBuffer = 1 << 16;
+constexpr std::size_t maximumFanIn = 64;
+
+// a temporary file together with the buffer stdio uses for it
+struct temporaryFile {
+	std::unique_ptr<char[]> buffer;
+	// declared after buffer, so the file is closed before its buffer is freed
+	std::unique_ptr<std::FILE, int (*)(std::FILE *)> file;
+};
+
+temporaryFile createTemporaryFile(std::size_t bufferSize) {
+	std::FILE * file = std::tmpfile();
+	if (file == nullptr) {
+		throw std::runtime_error { "Can not create a temporary file!" };
+	}
+	temporaryFile temporary { std::unique_ptr<char[]> { new char[bufferSize] }, { file, &std::fclose } };
+	// setvbuf is only allowed before any other operation on the stream
+	std::setvbuf(file, temporary.buffer.get(), _IOFBF, bufferSize);
+	return temporary;
+}
+
+// Splits the input into lines with large block reads instead of getline.
+class lineReader {
+	std::istream & is;
+	std::vector<char> block;
+	std::size_t position { 0 };
+	std::size_t filled { 0 };
+	std::string pending { };
+public:
+	explicit lineReader(std::istream & is) : is { is }, block(readBlockSize) {}
+
+	// the next line without its newline, false at the end of the input
+	bool next(std::string & line) {
+		line.clear();
+		while (true) {
+			if (position == filled) {
+				if (!is.read(block.data(), block.size()) && is.gcount() == 0) {
+					return !line.empty();
+				}
+				filled = is.gcount();
+				position = 0;
+			}
+			char const * begin = block.data() + position;
+			char const * end = block.data() + filled;
+			char const * newline = std::find(begin, end, '\n');
+			line.append(begin, newline);
+			position = newline - block.data();
+			if (newline != end) {
+				position++;
+				return true;
+			}
+		}
+	}
+};
+
+// One spilled rotation. The key joins the folded words with single spaces,
+// which sorts exactly like the word sequences because a space is smaller
+// than every letter. line and start break ties like rotationLess.
+struct runRecord {
+	std::uint64_t line { };
+	std::uint32_t start { };
+	std::string key { };
+	std::string text { };
+};
+
+bool operator<(runRecord const & lhs, runRecord const & rhs) {
+	int order = lhs.key.compare(rhs.key);
+	if (order != 0) {
+		return order < 0;
+	}
+	return lhs.line != rhs.line ? lhs.line < rhs.line : lhs.start < rhs.start;
+}
+
+void writeString(std::FILE * file, std::string const & s) {
+	std::uint32_t length = s.size();
+	std::fwrite(&length, sizeof(length), 1, file);
+	std::fwrite(s.data(), 1, s.size(), file);
+}
+
+// throws on an error or a truncated record
+void readExactly(std::FILE * file, void * data, std::size_t size) {
+	if (std::fread(data, 1, size, file) != size) {
+		throw std::runtime_error { "Can not read a temporary file!" };
+	}
+}
+
+void readString(std::FILE * file, std::string & s) {
+	std::uint32_t length { };
+	readExactly(file, &length, sizeof(length));
+	s.resize(length);
+	readExactly(file, s.data(), length);
+}
+
+void writeRecord(std::FILE * file, runRecord const & record) {
+	std::fwrite(&record.line, sizeof(record.line), 1, file);
+	std::fwrite(&record.start, sizeof(record.start), 1, file);
+	writeString(file, record.key);
+	writeString(file, record.text);
+}
+
+// false at the end of the run
+bool readRecord(std::FILE * file, runRecord & record) {
+	std::size_t read = std::fread(&record.line, 1, sizeof(record.line), file);
+	if (read == 0 && std::feof(file) && !std::ferror(file)) {
+		return false;
+	}
+	if (read != sizeof(record.line)) {
+		throw std::runtime_error { "Can not read a temporary file!" };
+	}
+	readExactly(file, &record.start, sizeof(record.start));
+	readString(file, record.key);
+	readString(file, record.text);
+	return true;
+}
+
+void finishWriting(std::FILE * file) {
+	if (std::fflush(file) != 0 || std::ferror(file)) {
+		throw std::runtime_error { "Can not write a temporary file!" };
+	}
+	std::rewind(file);
+}
+
+// sorts the index and writes it as a run buffered by bufferSize bytes, lines
+// are numbered from firstLine
+temporaryFile spill(rotationIndex & index, std::uint64_t firstLine, std::size_t bufferSize) {
+	index.sort();
+	temporaryFile run = createTemporaryFile(bufferSize);
+	lineStore const & store = index.lines();
+	runRecord record { };
+	for (rotation const r : index.sorted()) {
+		record.line = firstLine + r.line;
+		record.start = r.start;
+		record.key.clear();
+		record.text.clear();
+		std::uint32_t length = store.length(r.line);
+		for (std::uint32_t k = 0, position = r.start; k < length; k++) {
+			if (k != 0) {
+				record.key += ' ';
+			}
+			record.key += store.folded(r.line, position);
+			record.text += store.text(r.line, position);
+			record.text += ' ';
+			if (++position == length) {
+				position = 0;
+			}
+		}
+		writeRecord(run.file.get(), record);
+	}
+	finishWriting(run.file.get());
+	return run;
+}
+
+struct runCursor {
+	std::FILE * file;
+	runRecord record;
+};
+
+template <typename SINK>
+void mergeRuns(std::vector<temporaryFile> const & runs, SINK sink) {
+	auto later = [](runCursor const * lhs, runCursor const * rhs) {
+		return rhs->record < lhs->record;
+	};
+	std::vector<runCursor> cursors(runs.size());
+	std::priority_queue<runCursor *, std::vector<runCursor *>, decltype(later)> queue { later };
+	for (std::size_t i = 0; i < runs.size(); i++) {
+		cursors[i].file = runs[i].file.get();
+		if (readRecord(cursors[i].file, cursors[i].record)) {
+			queue.push(&cursors[i]);
+		}
+	}
+	while (!queue.empty()) {
+		runCursor * cursor = queue.top();
+		queue.pop();
+		sink(cursor->record);
+		if (readRecord(cursor->file, cursor->record)) {
+			queue.push(cursor);
+		}
+	}
+}
+
+}
+
+void externalKwic(std::istream & is, rotationWriter & out, std::size_t memoryBudget, textEncoding encoding) {
+	// the buffers of all merged runs share the budget
+	std::size_t fanIn = std::clamp<std::size_t>(memoryBudget / minimumRunBuffer, 2, maximumFanIn);
+	std::size_t bufferSize = std::max(minimumRunBuffer, memoryBudget / fanIn);
+	std::vector<temporaryFile> runs { };
+	rotationIndex index { encoding };
+	std::uint64_t firstLine = 0;
+	lineReader reader { is };
+	std::string inputline { };
+	while (reader.next(inputline)) {
+		index.addLine(inputline);
+		if (index.memoryUsage() >= memoryBudget) {
+			runs.push_back(spill(index, firstLine, bufferSize));
+			firstLine += index.lines().lines();
+			index = rotationIndex { encoding };
+		}
+	}
+
+	if (runs.empty()) {
+		index.sort();
+		index.write(out);
+		out.flush();
+		return;
+	}
+	if (!index.sorted().empty()) {
+		runs.push_back(spill(index, firstLine, bufferSize));
+	}
+	index = rotationIndex { encoding };
+
+	while (runs.size() > fanIn) {
+		std::vector<temporaryFile> merged { };
+		for (std::size_t first = 0; first < runs.size(); first += fanIn) {
+			std::size_t last = std::min(runs.size(), first + fanIn);
+			std::vector<temporaryFile> group(std::make_move_iterator(runs.begin() + first), std::make_move_iterator(runs.begin() + last));
+			temporaryFile output = createTemporaryFile(bufferSize);
+			mergeRuns(group, [&output](runRecord const & record) {
+				writeRecord(output.file.get(), record);
+			});
+			finishWriting(output.file.get());
+			merged.push_back(std::move(output));
+		}
+		runs = std::move(merged);
+	}
+	mergeRuns(runs, [&out](runRecord const & record) {
+		out.write(record.text);
+	});
+	out.flush();
+}
+
+}
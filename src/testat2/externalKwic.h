@@ -0,0 +1,22 @@
+#ifndef SRC_EXTERNALKWIC_H_
+#define SRC_EXTERNALKWIC_H_
+
+#include "utf8.h"
+
+#include <cstddef>
+#include <iosfwd>
+
+namespace text {
+
+	class rotationWriter;
+
+	// kwic with bounded memory: rotations are collected until their memory
+	// use reaches memoryBudget bytes, then sorted and spilled as a run to a
+	// temporary file. The runs are k-way merged into out, with as many runs
+	// per pass as fit into memoryBudget with a 64 KiB read buffer each, but
+	// at least 2 and at most 64. Produces the same output as kwic.
+	void externalKwic(std::istream & is, rotationWriter & out, std::size_t memoryBudget, textEncoding encoding = textEncoding::ascii);
+
+}
+
+#endif /* SRC_EXTERNALKWIC_H_ */
@@ -2,56 +2,121 @@
 #include <algorithm>
 #include <string>
 
+#include "externalKwic.h"
 #include "kwic.h"
+#include "rotation.h"
+#include "rotationWriter.h"
+#include "topKwic.h"
 #include "word.h"
 
+#include <cstdint>
+#include <future>
+#include <istream>
 #include <ostream>
-#include <sstream>
+#include <queue>
+#include <thread>
 
 
 namespace text {
 
-using wordVector = std::vector<Word>;
+namespace {
 
-void kwic(std::istream & is, std::ostream & os) {
-	std::vector<wordVector> inputlines { };
+// position of the next rotation of a chunk during the k-way merge
+struct mergeCursor {
+	rotationIndex const * chunk;
+	std::size_t chunkNumber;
+	std::size_t next;
 
+	rotation current() const {
+		return chunk->sorted()[next];
+	}
+};
+
+// Chunks hold consecutive runs of input lines, so breaking ties by chunk
+// number yields the same order as sorting all rotations at once.
+void writeMerged(std::vector<rotationIndex> const & chunks, rotationWriter & out) {
+	auto later = [](mergeCursor const & lhs, mergeCursor const & rhs) {
+		int order = compareRotations(lhs.chunk->lines(), lhs.current(), rhs.chunk->lines(), rhs.current());
+		return order != 0 ? order > 0 : lhs.chunkNumber > rhs.chunkNumber;
+	};
+	std::priority_queue<mergeCursor, std::vector<mergeCursor>, decltype(later)> cursors { later };
+	for (std::size_t k = 0; k < chunks.size(); k++) {
+		if (!chunks[k].sorted().empty()) {
+			cursors.push(mergeCursor { &chunks[k], k, 0 });
+		}
+	}
+	while (!cursors.empty()) {
+		mergeCursor cursor = cursors.top();
+		cursors.pop();
+		out.write(cursor.chunk->lines(), cursor.current());
+		if (++cursor.next < cursor.chunk->sorted().size()) {
+			cursors.push(cursor);
+		}
+	}
+	out.flush();
+}
+
+void parallelKwic(std::istream & is, rotationWriter & out, unsigned threads, textEncoding encoding) {
+	std::vector<std::string> inputlines { };
 	while (is.good()) {
 		std::string inputline {};
 		std::getline(is, inputline);
-		std::stringstream ss(inputline);
-
-		Word singleWord {};
-		wordVector line;
-
-		for (std::string::iterator it = inputline.begin(); it != inputline.end(); ++it) {
-			if(ss >> singleWord) {
-				line.push_back(singleWord);
-
-			}
-		}
+		inputlines.push_back(std::move(inputline));
+	}
 
-		for (int i = 0; i < line.size(); i++) {
-			inputlines.push_back(line);
-			std::rotate(line.begin(), line.begin() + 1, line.end());
+	std::size_t chunkCount = std::max<std::size_t>(1, std::min<std::size_t>(threads, inputlines.size()));
+	std::vector<rotationIndex> chunks { };
+	for (std::size_t k = 0; k < chunkCount; k++) {
+		chunks.emplace_back(encoding);
+	}
+	auto indexChunk = [&](std::size_t k) {
+		std::size_t first = k * inputlines.size() / chunkCount;
+		std::size_t last = (k + 1) * inputlines.size() / chunkCount;
+		for (std::size_t i = first; i < last; i++) {
+			chunks[k].addLine(inputlines[i]);
+			std::string{}.swap(inputlines[i]);
 		}
+		chunks[k].sort();
+	};
 
+	std::vector<std::future<void>> workers { };
+	for (std::size_t k = 1; k < chunkCount; k++) {
+		workers.push_back(std::async(std::launch::async, indexChunk, k));
+	}
+	indexChunk(0);
+	for (auto & worker : workers) {
+		worker.get();
 	}
 
-	std::sort(inputlines.begin(), inputlines.end());
-
-	std::for_each(inputlines.begin(), inputlines.end(), [& os](auto line){
-
-		std::for_each(line.begin(), line.end(), [& os](auto word){
-			os << word << " ";
-		});
-
-		os << std::endl;
-	});
-
+	writeMerged(chunks, out);
 }
 
+}
 
+void kwic(std::istream & is, std::ostream & os) {
+	kwic(is, os, kwicOptions { });
+}
 
+void kwic(std::istream & is, std::ostream & os, kwicOptions const & options) {
+	rotationWriter out { os, options.outputDescriptor };
+	unsigned threads = options.threads != 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+	if (options.stopWords || options.perKeyword != 0 || options.limit != 0) {
+		topKwic(is, out, options);
+	} else if (options.memoryBudget != 0) {
+		externalKwic(is, out, options.memoryBudget, options.encoding);
+	} else if (threads > 1) {
+		parallelKwic(is, out, threads, options.encoding);
+	} else {
+		rotationIndex index { options.encoding };
+		while (is.good()) {
+			std::string inputline {};
+			std::getline(is, inputline);
+			index.addLine(inputline);
+		}
+		index.sort();
+		index.write(out);
+		out.flush();
+	}
+}
 
 }
@@ -1,10 +1,45 @@
 #ifndef SRC_KWIC_H_
 #define SRC_KWIC_H_
 
+#include <cstddef>
+#include <iosfwd>
+
 namespace text {
 
+	class stopWordSet;
+	enum class textEncoding;
+
+	struct kwicOptions {
+		// worker threads for tokenizing and sorting, 0 uses all cores
+		unsigned threads { 1 };
+		// approximate bytes of rotations kept in memory, 0 means unlimited.
+		// When set, sorted runs are spilled to temporary files and merged,
+		// the thread count is ignored.
+		std::size_t memoryBudget { 0 };
+		// Rotations starting with one of these words are left out. The set
+		// must outlive the call, see englishStopWords.
+		stopWordSet const * stopWords { nullptr };
+		// at most this many rotations per keyword, the first word of a
+		// rotation, 0 means all
+		std::size_t perKeyword { 0 };
+		// at most this many rotations in total, 0 means all
+		std::size_t limit { 0 };
+		// With stopWords, perKeyword or limit set, kwic keeps only what it
+		// writes, and threads and memoryBudget are ignored.
+
+		// If not negative, the output is written with writev straight from
+		// the word storage to this file descriptor, and os is not used.
+		int outputDescriptor { -1 };
+
+		// ascii or utf8, see textEncoding
+		textEncoding encoding { };
+	};
+
 	void kwic(std::istream & is, std::ostream & os);
 
+	// Apart from the filters, the output does not depend on the options.
+	void kwic(std::istream & is, std::ostream & os, kwicOptions const & options);
+
 }
 
 #endif /* SRC_KWIC_H_ */
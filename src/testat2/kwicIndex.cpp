@@ -0,0 +1,160 @@
+#include "kwicIndex.h"
+#include "rotationWriter.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <queue>
+
+namespace text {
+
+namespace {
+
+// the order of rotationLess, based on the spellings because the ranks of a
+// growing store change
+class keyLess {
+	lineStore const * store;
+public:
+	explicit keyLess(lineStore const & store) : store{&store} {}
+
+	bool operator()(rotation lhs, rotation rhs) const {
+		int order = compareRotations(*store, lhs, *store, rhs);
+		if (order != 0) {
+			return order < 0;
+		}
+		return lhs.line != rhs.line ? lhs.line < rhs.line : lhs.start < rhs.start;
+	}
+};
+
+std::string folded(std::string_view s, textEncoding encoding) {
+	std::string result { };
+	foldCase(s, encoding, result);
+	return result;
+}
+
+}
+
+int compareKey(lineStore const & store, rotation r, std::string_view key, bool prefix) {
+	std::uint32_t length = store.length(r.line);
+	for (std::uint32_t k = 0, position = r.start; k < length; k++) {
+		if (k != 0) {
+			if (key.empty()) {
+				return prefix ? 0 : 1;
+			}
+			int order = std::string_view { " " }.compare(key.substr(0, 1));
+			if (order != 0) {
+				return order;
+			}
+			key.remove_prefix(1);
+		}
+		std::string_view word = store.folded(r.line, position);
+		std::size_t common = std::min(word.size(), key.size());
+		int order = word.substr(0, common).compare(key.substr(0, common));
+		if (order != 0) {
+			return order;
+		}
+		if (word.size() > key.size()) {
+			return prefix ? 0 : 1;
+		}
+		key.remove_prefix(common);
+		if (++position == length) {
+			position = 0;
+		}
+	}
+	return key.empty() ? 0 : -1;
+}
+
+void kwicIndex::addLine(std::string_view inputline) {
+	std::uint32_t words = store.addLine(inputline);
+	if (words == 0) {
+		return;
+	}
+	std::uint32_t lineNumber = store.lines() - 1;
+	std::vector<rotation> run { };
+	run.reserve(words);
+	for (std::uint32_t start = 0; start < words; start++) {
+		run.push_back(rotation { lineNumber, start });
+	}
+	keyLess less { store };
+	std::sort(run.begin(), run.end(), less);
+	count += words;
+
+	while (!runs.empty() && runs.back().size() < 2 * run.size()) {
+		std::vector<rotation> merged { };
+		merged.reserve(runs.back().size() + run.size());
+		std::merge(runs.back().begin(), runs.back().end(), run.begin(), run.end(), std::back_inserter(merged), less);
+		runs.pop_back();
+		run = std::move(merged);
+	}
+	runs.push_back(std::move(run));
+}
+
+std::vector<rotation> kwicIndex::lookup(std::string_view prefix) const {
+	std::string key = folded(prefix, store.inputEncoding());
+	std::vector<rotation> found { };
+	for (auto const & run : runs) {
+		auto first = std::partition_point(run.begin(), run.end(), [&](rotation r) {
+			return compareKey(store, r, key, true) < 0;
+		});
+		auto last = std::partition_point(first, run.end(), [&](rotation r) {
+			return compareKey(store, r, key, true) == 0;
+		});
+		found.insert(found.end(), first, last);
+	}
+	std::sort(found.begin(), found.end(), keyLess { store });
+	return found;
+}
+
+std::vector<rotation> kwicIndex::range(std::string_view from, std::string_view to) const {
+	std::string lower = folded(from, store.inputEncoding());
+	std::string upper = folded(to, store.inputEncoding());
+	std::vector<rotation> found { };
+	for (auto const & run : runs) {
+		auto first = std::partition_point(run.begin(), run.end(), [&](rotation r) {
+			return compareKey(store, r, lower, false) < 0;
+		});
+		auto last = std::partition_point(first, run.end(), [&](rotation r) {
+			return compareKey(store, r, upper, false) < 0;
+		});
+		found.insert(found.end(), first, last);
+	}
+	std::sort(found.begin(), found.end(), keyLess { store });
+	return found;
+}
+
+std::string kwicIndex::text(rotation r) const {
+	std::string line { };
+	std::uint32_t length = store.length(r.line);
+	for (std::uint32_t k = 0, position = r.start; k < length; k++) {
+		line += store.text(r.line, position);
+		line += ' ';
+		if (++position == length) {
+			position = 0;
+		}
+	}
+	return line;
+}
+
+void kwicIndex::write(std::ostream & os) const {
+	rotationWriter out { os };
+	using cursor = std::pair<std::vector<rotation>::const_iterator, std::vector<rotation>::const_iterator>;
+	keyLess less { store };
+	auto later = [&less](cursor const & lhs, cursor const & rhs) {
+		return less(*rhs.first, *lhs.first);
+	};
+	std::priority_queue<cursor, std::vector<cursor>, decltype(later)> cursors { later };
+	for (auto const & run : runs) {
+		cursors.push(cursor { run.begin(), run.end() });
+	}
+	while (!cursors.empty()) {
+		cursor next = cursors.top();
+		cursors.pop();
+		out.write(store, *next.first);
+		if (++next.first != next.second) {
+			cursors.push(next);
+		}
+	}
+	out.flush();
+}
+
+}
@@ -0,0 +1,60 @@
+#ifndef SRC_KWICINDEX_H_
+#define SRC_KWICINDEX_H_
+
+#include "rotation.h"
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace text {
+
+// Compares the key of r, its folded words joined by single spaces, with key.
+// Returns a negative value, zero or a positive value. With prefix set, zero
+// also means that the key of r starts with key.
+int compareKey(lineStore const & store, rotation r, std::string_view key, bool prefix);
+
+// A KWIC index that grows line by line and answers queries in between.
+// The rotations are kept in sorted runs whose sizes at least double from
+// the newest to the oldest, like a binary counter: a new line becomes a
+// run of its own and is merged with the newest run as long as that is not
+// at least twice as large. Adding is amortised O(log n) comparisons per
+// rotation, a query binary searches each of the O(log n) runs.
+class kwicIndex {
+	lineStore store;
+	std::vector<std::vector<rotation>> runs{};
+	std::size_t count{0};
+public:
+	explicit kwicIndex(textEncoding encoding = textEncoding::ascii) : store{encoding} {}
+
+	// splits the line into words and adds its rotations, lines without
+	// words are skipped
+	void addLine(std::string_view inputline);
+
+	// The rotations whose key starts with prefix, in output order. The key
+	// of a rotation consists of its case folded words joined by single
+	// spaces, the prefix is folded before the search.
+	std::vector<rotation> lookup(std::string_view prefix) const;
+
+	// the rotations with from <= key < to, in output order
+	std::vector<rotation> range(std::string_view from, std::string_view to) const;
+
+	// the rotation as written by write, without the newline
+	std::string text(rotation r) const;
+
+	// writes all rotations like kwic
+	void write(std::ostream & os) const;
+
+	std::size_t size() const {
+		return count;
+	}
+	lineStore const & lines() const {
+		return store;
+	}
+};
+
+}
+
+#endif /* SRC_KWICINDEX_H_ */
@@ -0,0 +1,116 @@
+#include "rotation.h"
+#include "rotationSort.h"
+#include "rotationWriter.h"
+#include "stopWords.h"
+#include "tokenizer.h"
+
+#include <algorithm>
+
+namespace text {
+
+std::uint32_t lineStore::addLine(std::string_view inputline) {
+	std::uint32_t words = 0;
+	forEachWord(inputline, encoding, [this, &words](std::string_view word) {
+		addWord(word);
+		words++;
+	});
+	if (words != 0) {
+		finishLine();
+	}
+	return words;
+}
+
+void lineStore::addWord(std::string_view text) {
+	scratch.clear();
+	foldCase(text, encoding, scratch);
+	textIds.push_back(spellings.intern(text));
+	keyIds.push_back(keys.intern(scratch));
+}
+
+std::uint32_t lineStore::finishLine() {
+	lineStarts.push_back(textIds.size());
+	return lines() - 1;
+}
+
+void lineStore::rankWords() {
+	std::vector<std::uint32_t> keyRanks = keys.collationRanks();
+	ranks.resize(keyIds.size());
+	for (std::size_t i = 0; i < keyIds.size(); i++) {
+		ranks[i] = keyRanks[keyIds[i]];
+	}
+}
+
+std::size_t lineStore::memoryUsage() const {
+	std::size_t perWord = sizeof(wordId) + sizeof(wordId) + sizeof(std::uint32_t);
+	return spellings.memoryUsage() + keys.memoryUsage() + textIds.size() * perWord + lineStarts.size() * sizeof(std::size_t);
+}
+
+int compareRotations(lineStore const & lhsStore, rotation lhs, lineStore const & rhsStore, rotation rhs) {
+	std::uint32_t lhsLength = lhsStore.length(lhs.line);
+	std::uint32_t rhsLength = rhsStore.length(rhs.line);
+	std::uint32_t common = std::min(lhsLength, rhsLength);
+	std::uint32_t lhsPosition = lhs.start;
+	std::uint32_t rhsPosition = rhs.start;
+	for (std::uint32_t k = 0; k < common; k++) {
+		int order = lhsStore.folded(lhs.line, lhsPosition).compare(rhsStore.folded(rhs.line, rhsPosition));
+		if (order != 0) {
+			return order;
+		}
+		if (++lhsPosition == lhsLength) {
+			lhsPosition = 0;
+		}
+		if (++rhsPosition == rhsLength) {
+			rhsPosition = 0;
+		}
+	}
+	return lhsLength < rhsLength ? -1 : lhsLength > rhsLength ? 1 : 0;
+}
+
+bool rotationLess::operator()(rotation lhs, rotation rhs) const {
+	std::uint32_t lhsLength = store->length(lhs.line);
+	std::uint32_t rhsLength = store->length(rhs.line);
+	std::uint32_t common = std::min(lhsLength, rhsLength);
+	std::uint32_t lhsPosition = lhs.start;
+	std::uint32_t rhsPosition = rhs.start;
+	for (std::uint32_t k = 0; k < common; k++) {
+		std::uint32_t lhsRank = store->rank(lhs.line, lhsPosition);
+		std::uint32_t rhsRank = store->rank(rhs.line, rhsPosition);
+		if (lhsRank != rhsRank) {
+			return lhsRank < rhsRank;
+		}
+		if (++lhsPosition == lhsLength) {
+			lhsPosition = 0;
+		}
+		if (++rhsPosition == rhsLength) {
+			rhsPosition = 0;
+		}
+	}
+	if (lhsLength != rhsLength) {
+		return lhsLength < rhsLength;
+	}
+	return lhs.line != rhs.line ? lhs.line < rhs.line : lhs.start < rhs.start;
+}
+
+void rotationIndex::addLine(std::string_view inputline, stopWordSet const * stopWords) {
+	std::uint32_t words = store.addLine(inputline);
+	std::uint32_t lineNumber = store.lines() - 1;
+	for (std::uint32_t start = 0; start < words; start++) {
+		if (stopWords && stopWords->contains(store.folded(lineNumber, start))) {
+			continue;
+		}
+		rotations.push_back(rotation { lineNumber, start });
+	}
+}
+
+void rotationIndex::sort() {
+	store.rankWords();
+	sortRotations(store, rotations);
+}
+
+void rotationIndex::write(rotationWriter & out) const {
+	for (rotation const r : rotations) {
+		out.write(store, r);
+	}
+}
+
+}
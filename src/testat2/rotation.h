@@ -0,0 +1,131 @@
+#ifndef SRC_ROTATION_H_
+#define SRC_ROTATION_H_
+
+#include "utf8.h"
+#include "wordPool.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace text {
+
+class stopWordSet;
+class rotationWriter;
+
+// The words of all input lines, stored once and line after line. Every
+// word is kept as two interned ids: its spelling for the output and its
+// lower case key for the comparisons.
+class lineStore {
+	wordPool spellings{};
+	wordPool keys{};
+	std::vector<wordId> textIds{};
+	std::vector<wordId> keyIds{};
+	// collation rank of the key of every word, filled by rankWords
+	std::vector<std::uint32_t> ranks{};
+	std::vector<std::size_t> lineStarts{0};
+	// buffer for folding the word being added
+	std::string scratch{};
+	textEncoding encoding;
+public:
+	explicit lineStore(textEncoding encoding = textEncoding::ascii) : encoding{encoding} {}
+
+	// splits the line into words and appends it, lines without words are
+	// skipped; returns the number of words
+	std::uint32_t addLine(std::string_view inputline);
+	// appends a word to the line being built
+	void addWord(std::string_view text);
+	// ends the line being built and returns its number
+	std::uint32_t finishLine();
+
+	textEncoding inputEncoding() const {
+		return encoding;
+	}
+
+	// computes the ranks of all words, needed by rotationLess
+	void rankWords();
+
+	std::size_t lines() const {
+		return lineStarts.size() - 1;
+	}
+	std::size_t words() const {
+		return textIds.size();
+	}
+	std::uint32_t length(std::uint32_t line) const {
+		return lineStarts[line + 1] - lineStarts[line];
+	}
+	std::string_view text(std::uint32_t line, std::uint32_t position) const {
+		return spellings[textIds[lineStarts[line] + position]];
+	}
+	std::string_view folded(std::uint32_t line, std::uint32_t position) const {
+		return keys[keyIds[lineStarts[line] + position]];
+	}
+	wordId key(std::uint32_t line, std::uint32_t position) const {
+		return keyIds[lineStarts[line] + position];
+	}
+	std::uint32_t rank(std::uint32_t line, std::uint32_t position) const {
+		return ranks[lineStarts[line] + position];
+	}
+
+	// approximate heap memory held by the store
+	std::size_t memoryUsage() const;
+};
+
+// The rotation of a stored line that begins with the word at start.
+struct rotation {
+	std::uint32_t line;
+	std::uint32_t start;
+};
+
+// Compares the word sequences of two rotations by their folded spellings,
+// the rotations may belong to different stores. Returns a negative value,
+// zero or a positive value.
+int compareRotations(lineStore const & lhsStore, rotation lhs, lineStore const & rhsStore, rotation rhs);
+
+// Orders rotations like the rotated word sequences they stand for, i.e.
+// lexicographically by Word::operator<. The words are visited lazily across
+// the wrap-around and compared by their ranks, which requires rankWords.
+// Equal sequences are ordered by line and start, which makes the order
+// total and the output independent of the sort algorithm.
+class rotationLess {
+	lineStore const * store;
+public:
+	explicit rotationLess(lineStore const & store) : store{&store} {}
+	bool operator()(rotation lhs, rotation rhs) const;
+};
+
+// The lines of (a part of) the input together with all their rotations.
+class rotationIndex {
+	lineStore store;
+	std::vector<rotation> rotations{};
+public:
+	explicit rotationIndex(textEncoding encoding = textEncoding::ascii) : store{encoding} {}
+
+	// splits the line into words and adds its rotations, lines without
+	// words are skipped, and so are rotations starting with a stop word
+	void addLine(std::string_view inputline, stopWordSet const * stopWords = nullptr);
+
+	// sorts the rotations by rotationLess, see sortRotations
+	void sort();
+
+	// writes the rotations in their current order, out must be flushed
+	// while the index is alive
+	void write(rotationWriter & out) const;
+
+	lineStore const & lines() const {
+		return store;
+	}
+	std::vector<rotation> const & sorted() const {
+		return rotations;
+	}
+	// approximate heap memory held by the index
+	std::size_t memoryUsage() const {
+		return store.memoryUsage() + rotations.size() * sizeof(rotation);
+	}
+};
+
+}
+
+#endif /* SRC_ROTATION_H_ */
@@ -0,0 +1,121 @@
+#include "rotationSort.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+
+namespace text {
+
+namespace {
+
+constexpr std::ptrdiff_t smallRange = 16;
+
+struct keyedRotation {
+	rotation r;
+	// symbol at the current depth: 0 past the end, otherwise rank + 1
+	std::uint32_t symbol;
+};
+
+std::uint32_t symbolAt(lineStore const & store, rotation r, std::uint32_t depth) {
+	std::uint32_t length = store.length(r.line);
+	if (depth >= length) {
+		return 0;
+	}
+	std::uint32_t position = r.start + depth;
+	if (position >= length) {
+		position -= length;
+	}
+	return store.rank(r.line, position) + 1;
+}
+
+bool inputOrder(keyedRotation const & lhs, keyedRotation const & rhs) {
+	return lhs.r.line != rhs.r.line ? lhs.r.line < rhs.r.line : lhs.r.start < rhs.r.start;
+}
+
+// rotationLess for rotations known to agree in the first depth words
+class depthLess {
+	lineStore const * store;
+	std::uint32_t depth;
+public:
+	depthLess(lineStore const & store, std::uint32_t depth) : store{&store}, depth{depth} {}
+
+	bool operator()(keyedRotation const & lhs, keyedRotation const & rhs) const {
+		for (std::uint32_t k = depth;; k++) {
+			std::uint32_t lhsSymbol = symbolAt(*store, lhs.r, k);
+			std::uint32_t rhsSymbol = symbolAt(*store, rhs.r, k);
+			if (lhsSymbol != rhsSymbol) {
+				return lhsSymbol < rhsSymbol;
+			}
+			if (lhsSymbol == 0) {
+				return inputOrder(lhs, rhs);
+			}
+		}
+	}
+};
+
+std::uint32_t medianOfThree(std::uint32_t a, std::uint32_t b, std::uint32_t c) {
+	return std::max(std::min(a, b), std::min(std::max(a, b), c));
+}
+
+// symbolsCached tells whether the symbols of the range are those at depth
+void multikeySort(lineStore const & store, keyedRotation * first, keyedRotation * last, std::uint32_t depth, bool symbolsCached) {
+	while (last - first > smallRange) {
+		if (!symbolsCached) {
+			for (keyedRotation * it = first; it != last; ++it) {
+				it->symbol = symbolAt(store, it->r, depth);
+			}
+		}
+		std::uint32_t pivot = medianOfThree(first->symbol, first[(last - first) / 2].symbol, last[-1].symbol);
+
+		keyedRotation * less = first;
+		keyedRotation * greater = last;
+		for (keyedRotation * it = first; it < greater;) {
+			if (it->symbol < pivot) {
+				std::swap(*less++, *it++);
+			} else if (it->symbol > pivot) {
+				std::swap(*it, *--greater);
+			} else {
+				++it;
+			}
+		}
+
+		multikeySort(store, first, less, depth, true);
+		multikeySort(store, greater, last, depth, true);
+		if (pivot == 0) {
+			std::sort(less, greater, inputOrder);
+			return;
+		}
+		first = less;
+		last = greater;
+		depth++;
+		symbolsCached = false;
+	}
+	std::sort(first, last, depthLess { store, depth });
+}
+
+}
+
+void sortRotations(lineStore const & store, std::vector<rotation> & rotations) {
+	if (rotations.size() < multikeyThreshold) {
+		comparisonSortRotations(store, rotations);
+	} else {
+		multikeySortRotations(store, rotations);
+	}
+}
+
+void comparisonSortRotations(lineStore const & store, std::vector<rotation> & rotations) {
+	std::sort(rotations.begin(), rotations.end(), rotationLess { store });
+}
+
+void multikeySortRotations(lineStore const & store, std::vector<rotation> & rotations) {
+	std::vector<keyedRotation> keyed(rotations.size());
+	for (std::size_t i = 0; i < rotations.size(); i++) {
+		keyed[i].r = rotations[i];
+	}
+	multikeySort(store, keyed.data(), keyed.data() + keyed.size(), 0, false);
+	for (std::size_t i = 0; i < rotations.size(); i++) {
+		rotations[i] = keyed[i].r;
+	}
+}
+
+}
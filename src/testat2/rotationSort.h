@@ -0,0 +1,30 @@
+#ifndef SRC_ROTATIONSORT_H_
+#define SRC_ROTATIONSORT_H_
+
+#include "rotation.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace text {
+
+// from this many rotations on sortRotations uses the multikey quicksort
+constexpr std::size_t multikeyThreshold = 256;
+
+// Sorts by rotationLess, the store must be ranked. Picks the faster of
+// the two algorithms below for the number of rotations.
+void sortRotations(lineStore const & store, std::vector<rotation> & rotations);
+
+// std::sort with rotationLess
+void comparisonSortRotations(lineStore const & store, std::vector<rotation> & rotations);
+
+// Multikey quicksort (Bentley and Sedgewick) over the word ranks of the
+// rotations. Each pass partitions by the rank at one depth, which is cached
+// next to the rotation, so a word is looked up once per level instead of
+// once per comparison. Rotations equal in all words are ordered by line and
+// start, which gives exactly the order of rotationLess.
+void multikeySortRotations(lineStore const & store, std::vector<rotation> & rotations);
+
+}
+
+#endif /* SRC_ROTATIONSORT_H_ */
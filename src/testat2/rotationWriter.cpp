@@ -0,0 +1,129 @@
+#include "rotationWriter.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <ostream>
+#include <system_error>
+
+#include <unistd.h>
+
+namespace text {
+
+namespace {
+
+constexpr char space[] = " ";
+constexpr char newline[] = "\n";
+// gather limit of one writev call
+constexpr std::size_t maxVectors = IOV_MAX;
+
+}
+
+rotationWriter::rotationWriter(std::ostream & os, int descriptor)
+	: os{&os}, descriptor{descriptor}, buffer(capacity) {
+	if (descriptor >= 0) {
+		pending.reserve(maxVectors);
+	}
+}
+
+void rotationWriter::write(lineStore const & store, rotation r) {
+	std::uint32_t length = store.length(r.line);
+	for (std::uint32_t k = 0, position = r.start; k < length; k++) {
+		if (descriptor >= 0) {
+			gather(store.text(r.line, position));
+			gather(std::string_view { space, 1 });
+		} else {
+			append(store.text(r.line, position));
+			append(std::string_view { space, 1 });
+		}
+		if (++position == length) {
+			position = 0;
+		}
+	}
+	if (descriptor >= 0) {
+		gather(std::string_view { newline, 1 });
+	} else {
+		append(std::string_view { newline, 1 });
+	}
+}
+
+void rotationWriter::write(std::string_view line) {
+	if (line.size() + 1 > capacity - used) {
+		flush();
+	}
+	if (line.size() + 1 > capacity) {
+		// too large for the buffer, the line goes out on its own at once
+		if (descriptor >= 0) {
+			gather(line);
+			gather(std::string_view { newline, 1 });
+			writePending();
+		} else {
+			os->write(line.data(), line.size());
+			os->put('\n');
+		}
+		return;
+	}
+	char * first = buffer.data() + used;
+	std::memcpy(first, line.data(), line.size());
+	first[line.size()] = '\n';
+	used += line.size() + 1;
+	if (descriptor >= 0) {
+		gather(std::string_view { first, line.size() + 1 });
+	}
+}
+
+void rotationWriter::flush() {
+	if (descriptor >= 0) {
+		writePending();
+	} else if (used != 0) {
+		os->write(buffer.data(), used);
+	}
+	used = 0;
+}
+
+void rotationWriter::append(std::string_view bytes) {
+	if (bytes.size() > capacity - used) {
+		flush();
+		if (bytes.size() > capacity) {
+			os->write(bytes.data(), bytes.size());
+			return;
+		}
+	}
+	std::memcpy(buffer.data() + used, bytes.data(), bytes.size());
+	used += bytes.size();
+}
+
+void rotationWriter::gather(std::string_view bytes) {
+	if (pending.size() == maxVectors) {
+		writePending();
+	}
+	pending.push_back(iovec { const_cast<char *>(bytes.data()), bytes.size() });
+}
+
+void rotationWriter::writePending() {
+	iovec * first = pending.data();
+	iovec * last = first + pending.size();
+	while (first != last) {
+		ssize_t written = ::writev(descriptor, first, last - first);
+		if (written < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			throw std::system_error(errno, std::generic_category(), "Can not write the output");
+		}
+		// skip what was written, a partially written vector is adjusted
+		std::size_t left = written;
+		while (first != last && left >= first->iov_len) {
+			left -= first->iov_len;
+			++first;
+		}
+		if (left != 0) {
+			first->iov_base = static_cast<char *>(first->iov_base) + left;
+			first->iov_len -= left;
+		}
+	}
+	pending.clear();
+}
+
+}
@@ -0,0 +1,51 @@
+#ifndef SRC_ROTATIONWRITER_H_
+#define SRC_ROTATIONWRITER_H_
+
+#include "rotation.h"
+
+#include <cstddef>
+#include <iosfwd>
+#include <string_view>
+#include <vector>
+
+#include <sys/uio.h>
+
+namespace text {
+
+// Output stage of kwic. By default rotations are formatted into a reusable
+// buffer, which is handed to os in large blocks; os itself is never
+// flushed. With a file descriptor the words are not copied at all: every
+// line is gathered as iovecs pointing into the word storage and written
+// with writev. The store must then stay unchanged until flush.
+// flush must be called at the end, the destructor does not write.
+class rotationWriter {
+	static constexpr std::size_t capacity = 64 * 1024;
+
+	std::ostream * os;
+	int descriptor;
+	std::vector<char> buffer;
+	std::size_t used{0};
+	std::vector<iovec> pending{};
+public:
+	// writes to descriptor with writev if it is not negative, otherwise to os
+	explicit rotationWriter(std::ostream & os, int descriptor = -1);
+	rotationWriter(rotationWriter const &) = delete;
+	rotationWriter & operator=(rotationWriter const &) = delete;
+
+	// the words of the rotation, each followed by a space, and a newline
+	void write(lineStore const & store, rotation r);
+	// line and a newline, line is copied
+	void write(std::string_view line);
+
+	// writes everything pending, throws std::system_error if writev fails
+	void flush();
+
+private:
+	void append(std::string_view bytes);
+	void gather(std::string_view bytes);
+	void writePending();
+};
+
+}
+
+#endif /* SRC_ROTATIONWRITER_H_ */
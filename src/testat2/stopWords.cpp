@@ -0,0 +1,120 @@
+#include "stopWords.h"
+
+#include <algorithm>
+#include <cctype>
+
+namespace text {
+
+namespace {
+
+// FNV-1a, the seed is mixed into the offset basis
+std::uint32_t hash(std::string_view word, std::uint32_t seed) {
+	std::uint32_t h = 2166136261u ^ (seed * 0x9e3779b9u);
+	for (char c : word) {
+		h ^= static_cast<unsigned char>(c);
+		h *= 16777619u;
+	}
+	return h ^ (h >> 15);
+}
+
+constexpr std::uint32_t maxSeed = 1 << 16;
+
+}
+
+stopWordSet::stopWordSet(std::initializer_list<std::string_view> words) {
+	build(std::vector<std::string>(words.begin(), words.end()));
+}
+
+stopWordSet::stopWordSet(std::vector<std::string> const & words) {
+	build(words);
+}
+
+void stopWordSet::build(std::vector<std::string> words) {
+	for (auto & word : words) {
+		for (auto & c : word) {
+			c = std::tolower(static_cast<unsigned char>(c));
+		}
+	}
+	std::sort(words.begin(), words.end());
+	words.erase(std::unique(words.begin(), words.end()), words.end());
+	words.erase(std::remove(words.begin(), words.end(), std::string { }), words.end());
+	count = words.size();
+	if (count == 0) {
+		return;
+	}
+
+	for (std::size_t slotCount = count + count / 4 + 1;; slotCount += slotCount / 2) {
+		std::size_t bucketCount = count / 4 + 1;
+		std::vector<std::vector<std::string const *>> buckets(bucketCount);
+		for (auto const & word : words) {
+			buckets[hash(word, 0) % bucketCount].push_back(&word);
+		}
+		std::vector<std::size_t> order(bucketCount);
+		for (std::size_t i = 0; i < bucketCount; i++) {
+			order[i] = i;
+		}
+		std::stable_sort(order.begin(), order.end(), [&buckets](std::size_t lhs, std::size_t rhs) {
+			return buckets[lhs].size() > buckets[rhs].size();
+		});
+
+		slots.assign(slotCount, std::string { });
+		seeds.assign(bucketCount, 0);
+		std::vector<bool> used(slotCount);
+		bool placedAll = true;
+		for (std::size_t b : order) {
+			auto const & bucket = buckets[b];
+			if (bucket.empty()) {
+				break;
+			}
+			std::uint32_t seed = 1;
+			std::vector<std::size_t> chosen { };
+			for (; seed < maxSeed; seed++) {
+				chosen.clear();
+				for (auto word : bucket) {
+					std::size_t slot = hash(*word, seed) % slotCount;
+					if (used[slot] || std::find(chosen.begin(), chosen.end(), slot) != chosen.end()) {
+						break;
+					}
+					chosen.push_back(slot);
+				}
+				if (chosen.size() == bucket.size()) {
+					break;
+				}
+			}
+			if (seed == maxSeed) {
+				placedAll = false;
+				break;
+			}
+			seeds[b] = seed;
+			for (std::size_t i = 0; i < bucket.size(); i++) {
+				used[chosen[i]] = true;
+				slots[chosen[i]] = *bucket[i];
+			}
+		}
+		if (placedAll) {
+			return;
+		}
+	}
+}
+
+bool stopWordSet::contains(std::string_view word) const {
+	if (count == 0) {
+		return false;
+	}
+	std::uint32_t seed = seeds[hash(word, 0) % seeds.size()];
+	return seed != 0 && slots[hash(word, seed) % slots.size()] == word;
+}
+
+stopWordSet const & englishStopWords() {
+	static stopWordSet const words { "a", "about", "above", "after", "again", "against", "all", "am", "an", "and", "any", "are", "as", "at",
+		"be", "because", "been", "before", "being", "below", "between", "both", "but", "by", "can", "could", "did", "do", "does", "doing",
+		"down", "during", "each", "few", "for", "from", "further", "had", "has", "have", "having", "he", "her", "here", "hers", "herself",
+		"him", "himself", "his", "how", "i", "if", "in", "into", "is", "it", "its", "itself", "just", "me", "more", "most", "my", "myself",
+		"no", "nor", "not", "now", "of", "off", "on", "once", "only", "or", "other", "our", "ours", "ourselves", "out", "over", "own",
+		"same", "she", "should", "so", "some", "such", "than", "that", "the", "their", "theirs", "them", "themselves", "then", "there",
+		"these", "they", "this", "those", "through", "to", "too", "under", "until", "up", "very", "was", "we", "were", "what", "when",
+		"where", "which", "while", "who", "whom", "why", "will", "with", "would", "you", "your", "yours", "yourself", "yourselves" };
+	return words;
+}
+
+}
@@ -0,0 +1,42 @@
+#ifndef SRC_STOPWORDS_H_
+#define SRC_STOPWORDS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace text {
+
+// Immutable set of words built once at load time. Lookups use a perfect
+// hash (hash and displace): the first hash selects a bucket, the bucket's
+// seed selects the slot, so contains costs two hashes and one comparison
+// and never probes. Words are case insensitive.
+class stopWordSet {
+	std::vector<std::string> slots{};
+	std::vector<std::uint32_t> seeds{};
+	std::size_t count{0};
+public:
+	stopWordSet() = default;
+	explicit stopWordSet(std::initializer_list<std::string_view> words);
+	explicit stopWordSet(std::vector<std::string> const & words);
+
+	// word must be lower case, like the folded keys of the index
+	bool contains(std::string_view word) const;
+
+	std::size_t size() const {
+		return count;
+	}
+
+private:
+	void build(std::vector<std::string> words);
+};
+
+// common English function words such as "the", "a" and "of"
+stopWordSet const & englishStopWords();
+
+}
+
+#endif /* SRC_STOPWORDS_H_ */
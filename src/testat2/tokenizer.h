@@ -0,0 +1,70 @@
+#ifndef SRC_TOKENIZER_H_
+#define SRC_TOKENIZER_H_
+
+#include <array>
+#include <string_view>
+
+namespace text {
+
+namespace detail {
+
+constexpr std::array<bool, 256> makeLetterTable() {
+	std::array<bool, 256> table { };
+	for (int c = 'a'; c <= 'z'; c++) {
+		table[c] = true;
+		table[c - 'a' + 'A'] = true;
+	}
+	return table;
+}
+
+inline constexpr std::array<bool, 256> letterTable = makeLetterTable();
+
+}
+
+// true for the characters words consist of, the letters of the "C" locale
+constexpr bool isLetter(char c) {
+	return detail::letterTable[static_cast<unsigned char>(c)];
+}
+
+// Splits a buffer into words, the maximal runs of letters, without copying.
+// The returned views point into the buffer, which must outlive them.
+class tokenizer {
+	char const * current;
+	char const * last;
+public:
+	explicit tokenizer(std::string_view text) : current{text.data()}, last{text.data() + text.size()} {}
+
+	// stores the next word in word, false if there is none
+	bool next(std::string_view & word) {
+		while (current != last && !isLetter(*current)) {
+			++current;
+		}
+		if (current == last) {
+			return false;
+		}
+		char const * first = current;
+		while (++current != last && isLetter(*current)) {
+		}
+		word = std::string_view(first, current - first);
+		return true;
+	}
+
+	// the part of the buffer not yet scanned
+	std::string_view rest() const {
+		return std::string_view(current, last - current);
+	}
+};
+
+// calls function with every word of text
+template <typename FUNCTION>
+void forEachWord(std::string_view text, FUNCTION function) {
+	tokenizer words { text };
+	std::string_view word { };
+	while (words.next(word)) {
+		function(word);
+	}
+}
+
+}
+
+#endif /* SRC_TOKENIZER_H_ */
@@ -0,0 +1,169 @@
+#include "topKwic.h"
+#include "rotation.h"
+#include "rotationWriter.h"
+#include "stopWords.h"
+
+#include <algorithm>
+#include <functional>
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace text {
+
+namespace {
+
+constexpr std::size_t minimumCompaction = 1 << 16;
+
+// rotationLess based on the spellings, the ranks of a growing store change
+class spellingLess {
+	lineStore const * store;
+public:
+	explicit spellingLess(lineStore const & store) : store{&store} {}
+
+	bool operator()(rotation lhs, rotation rhs) const {
+		int order = compareRotations(*store, lhs, *store, rhs);
+		if (order != 0) {
+			return order < 0;
+		}
+		return lhs.line != rhs.line ? lhs.line < rhs.line : lhs.start < rhs.start;
+	}
+};
+
+// All rotations starting with a keyword sort next to each other, so the
+// first limit rotations of the output are the best ones of the smallest
+// keywords. Each keyword keeps a max heap of at most capacity rotations.
+// Once the keywords before the largest one hold limit rotations, the
+// largest one and every keyword after it can be dropped for good.
+class rotationSelector {
+	lineStore store;
+	std::size_t capacity;
+	std::size_t limit;
+	std::map<std::string, std::vector<rotation>, std::less<>> heaps { };
+	std::size_t kept { 0 };
+	std::optional<std::string> cutoff { };
+	std::size_t compactAt { minimumCompaction };
+public:
+	rotationSelector(std::size_t perKeyword, std::size_t limit, textEncoding encoding)
+		: store { encoding }, capacity { std::min(perKeyword, limit) }, limit { limit } {}
+
+	void addLine(std::string_view inputline, stopWordSet const * stopWords) {
+		std::uint32_t words = store.addLine(inputline);
+		std::uint32_t line = store.lines() - 1;
+		for (std::uint32_t start = 0; start < words; start++) {
+			std::string_view keyword = store.folded(line, start);
+			if (stopWords && stopWords->contains(keyword)) {
+				continue;
+			}
+			offer(keyword, rotation { line, start });
+		}
+		if (store.words() >= compactAt) {
+			compact();
+		}
+	}
+
+	void write(rotationWriter & out) {
+		spellingLess less { store };
+		std::size_t written = 0;
+		for (auto & entry : heaps) {
+			std::sort_heap(entry.second.begin(), entry.second.end(), less);
+			for (rotation const r : entry.second) {
+				if (written++ == limit) {
+					return;
+				}
+				out.write(store, r);
+			}
+		}
+	}
+
+private:
+	void offer(std::string_view keyword, rotation r) {
+		if (cutoff && keyword >= *cutoff) {
+			return;
+		}
+		spellingLess less { store };
+		auto found = heaps.find(keyword);
+		if (found == heaps.end()) {
+			found = heaps.emplace(std::string { keyword }, std::vector<rotation> { }).first;
+		}
+		auto & heap = found->second;
+		if (heap.size() < capacity) {
+			heap.push_back(r);
+			std::push_heap(heap.begin(), heap.end(), less);
+			kept++;
+		} else if (less(r, heap.front())) {
+			std::pop_heap(heap.begin(), heap.end(), less);
+			heap.back() = r;
+			std::push_heap(heap.begin(), heap.end(), less);
+		} else {
+			return;
+		}
+		while (kept - heaps.rbegin()->second.size() >= limit) {
+			auto last = std::prev(heaps.end());
+			kept -= last->second.size();
+			cutoff = last->first;
+			heaps.erase(last);
+		}
+	}
+
+	// copies the lines still referenced into a new store, in their order so
+	// that ties between equal rotations are still broken the same way
+	void compact() {
+		std::vector<std::uint32_t> referenced { };
+		for (auto const & entry : heaps) {
+			for (rotation const r : entry.second) {
+				referenced.push_back(r.line);
+			}
+		}
+		std::sort(referenced.begin(), referenced.end());
+		referenced.erase(std::unique(referenced.begin(), referenced.end()), referenced.end());
+
+		lineStore compacted { store.inputEncoding() };
+		for (std::uint32_t line : referenced) {
+			for (std::uint32_t position = 0; position < store.length(line); position++) {
+				compacted.addWord(store.text(line, position));
+			}
+			compacted.finishLine();
+		}
+		for (auto & entry : heaps) {
+			for (rotation & r : entry.second) {
+				r.line = std::lower_bound(referenced.begin(), referenced.end(), r.line) - referenced.begin();
+			}
+		}
+		store = std::move(compacted);
+		compactAt = std::max(minimumCompaction, 2 * store.words());
+	}
+};
+
+}
+
+void topKwic(std::istream & is, rotationWriter & out, kwicOptions const & options) {
+	if (options.perKeyword == 0 && options.limit == 0) {
+		rotationIndex index { options.encoding };
+		while (is.good()) {
+			std::string inputline { };
+			std::getline(is, inputline);
+			index.addLine(inputline, options.stopWords);
+		}
+		index.sort();
+		index.write(out);
+		out.flush();
+		return;
+	}
+
+	constexpr std::size_t unlimited = std::numeric_limits<std::size_t>::max();
+	rotationSelector selector { options.perKeyword != 0 ? options.perKeyword : unlimited, options.limit != 0 ? options.limit : unlimited, options.encoding };
+	while (is.good()) {
+		std::string inputline { };
+		std::getline(is, inputline);
+		selector.addLine(inputline, options.stopWords);
+	}
+	selector.write(out);
+	out.flush();
+}
+
+}
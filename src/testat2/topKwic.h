@@ -0,0 +1,22 @@
+#ifndef SRC_TOPKWIC_H_
+#define SRC_TOPKWIC_H_
+
+#include "kwic.h"
+
+#include <iosfwd>
+
+namespace text {
+
+	class rotationWriter;
+
+	// kwic restricted by the stop words, perKeyword and limit of options.
+	// Rotations starting with a stop word are never stored. With a limit,
+	// the others are kept in bounded heaps per keyword, the first word of a
+	// rotation, and lines no kept rotation refers to are dropped from time
+	// to time, so memory grows with the output rather than the input. Writes
+	// the same lines as filtering the output of kwic.
+	void topKwic(std::istream & is, rotationWriter & out, kwicOptions const & options);
+
+}
+
+#endif /* SRC_TOPKWIC_H_ */
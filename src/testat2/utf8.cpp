@@ -0,0 +1,187 @@
+#include "utf8.h"
+
+#include <bit>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace text {
+
+std::size_t decodeUtf8(char const * first, char const * last, char32_t & c) {
+	auto byte = [first](std::size_t i) {
+		return static_cast<unsigned char>(first[i]);
+	};
+	std::size_t available = last - first;
+	if (available == 0) {
+		return 0;
+	}
+	unsigned char lead = byte(0);
+	std::size_t length { };
+	char32_t minimum { };
+	if (lead < 0x80) {
+		c = lead;
+		return 1;
+	} else if (lead >= 0xc2 && lead < 0xe0) {
+		length = 2;
+		minimum = 0x80;
+		c = lead & 0x1f;
+	} else if (lead >= 0xe0 && lead < 0xf0) {
+		length = 3;
+		minimum = 0x800;
+		c = lead & 0x0f;
+	} else if (lead >= 0xf0 && lead < 0xf5) {
+		length = 4;
+		minimum = 0x10000;
+		c = lead & 0x07;
+	} else {
+		return 0;
+	}
+	if (available < length) {
+		return 0;
+	}
+	for (std::size_t i = 1; i < length; i++) {
+		if ((byte(i) & 0xc0) != 0x80) {
+			return 0;
+		}
+		c = (c << 6) | (byte(i) & 0x3f);
+	}
+	if (c < minimum || c > 0x10ffff || (c >= 0xd800 && c <= 0xdfff)) {
+		return 0;
+	}
+	return length;
+}
+
+void appendUtf8(std::string & out, char32_t c) {
+	if (c < 0x80) {
+		out += static_cast<char>(c);
+	} else if (c < 0x800) {
+		out += static_cast<char>(0xc0 | (c >> 6));
+		out += static_cast<char>(0x80 | (c & 0x3f));
+	} else if (c < 0x10000) {
+		out += static_cast<char>(0xe0 | (c >> 12));
+		out += static_cast<char>(0x80 | ((c >> 6) & 0x3f));
+		out += static_cast<char>(0x80 | (c & 0x3f));
+	} else {
+		out += static_cast<char>(0xf0 | (c >> 18));
+		out += static_cast<char>(0x80 | ((c >> 12) & 0x3f));
+		out += static_cast<char>(0x80 | ((c >> 6) & 0x3f));
+		out += static_cast<char>(0x80 | (c & 0x3f));
+	}
+}
+
+std::size_t asciiPrefix(char const * first, char const * last) {
+	char const * p = first;
+#if defined(__SSE2__)
+	for (; last - p >= 16; p += 16) {
+		int mask = _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const *>(p)));
+		if (mask != 0) {
+			return p - first + std::countr_zero(static_cast<unsigned>(mask));
+		}
+	}
+#else
+	if constexpr (std::endian::native == std::endian::little) {
+		for (; last - p >= 8; p += 8) {
+			std::uint64_t block { };
+			std::memcpy(&block, p, sizeof(block));
+			std::uint64_t high = block & 0x8080808080808080u;
+			if (high != 0) {
+				return p - first + std::countr_zero(high) / 8;
+			}
+		}
+	}
+#endif
+	while (p != last && static_cast<unsigned char>(*p) < 0x80) {
+		++p;
+	}
+	return p - first;
+}
+
+void foldCase(std::string_view word, textEncoding encoding, std::string & out) {
+	char const * p = word.data();
+	char const * last = p + word.size();
+	while (p != last) {
+		std::size_t ascii = encoding == textEncoding::ascii ? last - p : asciiPrefix(p, last);
+		for (char const * end = p + ascii; p != end; ++p) {
+			out += static_cast<char>(std::tolower(static_cast<unsigned char>(*p)));
+		}
+		if (p == last) {
+			break;
+		}
+		char32_t c { };
+		std::size_t length = decodeUtf8(p, last, c);
+		if (length == 0) {
+			// not UTF-8, kept as it is
+			out += *p++;
+			continue;
+		}
+		appendUtf8(out, foldCodePoint(c));
+		p += length;
+	}
+}
+
+namespace {
+
+// the length of the non-ASCII letter at p, 0 if there is none
+std::size_t letterAt(char const * p, char const * last) {
+	char32_t c { };
+	std::size_t length = decodeUtf8(p, last, c);
+	return length != 0 && isUnicodeLetter(c) ? length : 0;
+}
+
+}
+
+// works on local copies of the members, which the compiler may keep in
+// registers because the character reads can not alias them
+bool utf8Tokenizer::next(std::string_view & word) {
+	char const * p = current;
+	char const * asciiLimit = asciiEnd;
+	while (true) {
+		while (p < asciiLimit && !isLetter(*p)) {
+			++p;
+		}
+		if (p == last || p < asciiLimit) {
+			break;
+		}
+		if (static_cast<unsigned char>(*p) < 0x80) {
+			asciiLimit = p + asciiPrefix(p, last);
+		} else if (letterAt(p, last) != 0) {
+			break;
+		} else {
+			// invalid bytes and other characters separate words
+			char32_t c { };
+			std::size_t skipped = decodeUtf8(p, last, c);
+			p += skipped != 0 ? skipped : 1;
+		}
+	}
+	if (p == last) {
+		current = p;
+		asciiEnd = asciiLimit;
+		return false;
+	}
+	char const * first = p;
+	while (true) {
+		while (p < asciiLimit && isLetter(*p)) {
+			++p;
+		}
+		if (p == last || p < asciiLimit) {
+			break;
+		}
+		if (static_cast<unsigned char>(*p) < 0x80) {
+			asciiLimit = p + asciiPrefix(p, last);
+		} else if (std::size_t length = letterAt(p, last)) {
+			p += length;
+		} else {
+			break;
+		}
+	}
+	current = p;
+	asciiEnd = asciiLimit;
+	word = std::string_view(first, p - first);
+	return true;
+}
+
+}
@@ -0,0 +1,69 @@
+#ifndef SRC_UTF8_H_
+#define SRC_UTF8_H_
+
+#include "tokenizer.h"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace text {
+
+// How the bytes of the input are read. ascii is the original behaviour:
+// words consist of the letters of the "C" locale and every other byte
+// separates them. utf8 also accepts Unicode letters and folds them with
+// the simple case folding of Unicode. Invalid UTF-8 separates words.
+enum class textEncoding { ascii, utf8 };
+
+// letters (general category L) and combining marks (M) above 0x7f
+bool isUnicodeLetter(char32_t c);
+
+// simple case folding of c
+char32_t foldCodePoint(char32_t c);
+
+// Decodes the code point starting at first into c and returns its length
+// in bytes, or 0 for an invalid, overlong or truncated sequence.
+std::size_t decodeUtf8(char const * first, char const * last, char32_t & c);
+
+void appendUtf8(std::string & out, char32_t c);
+
+// the number of leading bytes of [first, last) below 0x80, 16 at a time
+// with SSE2
+std::size_t asciiPrefix(char const * first, char const * last);
+
+// appends the case folded word to out
+void foldCase(std::string_view word, textEncoding encoding, std::string & out);
+
+// Splits UTF-8 text into words, the maximal runs of letters. Pure ASCII
+// stretches, found with asciiPrefix, are scanned with the byte table of
+// the ASCII tokenizer, only other bytes are decoded.
+class utf8Tokenizer {
+	char const * current;
+	char const * last;
+	// end of the ASCII stretch current is in
+	char const * asciiEnd;
+public:
+	explicit utf8Tokenizer(std::string_view text)
+		: current{text.data()}, last{text.data() + text.size()}, asciiEnd{text.data()} {}
+
+	// stores the next word in word, false if there is none
+	bool next(std::string_view & word);
+};
+
+// calls function with every word of text
+template <typename FUNCTION>
+void forEachWord(std::string_view text, textEncoding encoding, FUNCTION function) {
+	if (encoding == textEncoding::ascii) {
+		forEachWord(text, function);
+		return;
+	}
+	utf8Tokenizer words { text };
+	std::string_view word { };
+	while (words.next(word)) {
+		function(word);
+	}
+}
+
+}
+
+#endif /* SRC_UTF8_H_ */
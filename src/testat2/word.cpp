@@ -1,4 +1,5 @@
 #include "word.h"
+#include "tokenizer.h"
 #include <iostream>
 #include <algorithm>
 #include <cctype>
@@ -7,6 +8,14 @@
 
 namespace text {
 
+std::string toLowerCase(std::string const & s) {
+	std::string temp = s;
+	for (auto & c : temp) {
+		c = tolower(static_cast<unsigned char>(c));
+	}
+	return temp;
+}
+
 Word::Word(std::string const input) {
 	if(input.size() == 0) {
 		throw std::invalid_argument("Can not create an empty word");
@@ -19,22 +28,41 @@ Word::Word(std::string const input) {
 	});
 
 	word = input;
+	key = toLowerCase(input);
 }
 
-std::string toLowerCase(std::string const & s) {
-	std::string temp = s;
-	for (auto & c : temp) {
-		c = tolower(c);
+Word::Word(std::string const input, textEncoding encoding) {
+	if (encoding == textEncoding::ascii) {
+		*this = Word { input };
+		return;
 	}
-	return temp;
+	if(input.size() == 0) {
+		throw std::invalid_argument("Can not create an empty word");
+	}
+
+	utf8Tokenizer words { input };
+	std::string_view letters { };
+	if (!words.next(letters) || letters.size() != input.size()) {
+		throw std::invalid_argument("Can't create word with invalid args");
+	}
+
+	*this = fromLetters(letters, encoding);
+}
+
+Word Word::fromLetters(std::string_view letters, textEncoding encoding) {
+	Word result { };
+	result.word.assign(letters);
+	result.key.clear();
+	foldCase(letters, encoding, result.key);
+	return result;
 }
 
 bool Word::operator <(Word const & rhs) const {
-	return toLowerCase(word) < toLowerCase(rhs.word);
+	return key < rhs.key;
 }
 
 bool Word::operator ==(Word const & rhs) const {
-	return !toLowerCase(word).compare(toLowerCase(rhs.word));
+	return key == rhs.key;
 }
 
 std::ostream & operator<<(std::ostream & os, Word const & word) {
@@ -42,44 +70,37 @@ std::ostream & operator<<(std::ostream & os, Word const & word) {
 	return os;
 }
 
+// Works on the stream buffer directly and classifies characters like the
+// tokenizer, so reading a word costs no sentry or peek per character.
 std::istream & operator>>(std::istream & is, Word & word) {
 	if(is.eof() || is.fail()) {
 		is.setstate(std::ios::failbit);
 		return is;
 	}
 
-	while (is.good()) {
-		char input = is.peek();
-		if (isalpha(input) == 0) {
-			is.ignore();
-		} else {
-			break;
-		}
+	using traits = std::istream::traits_type;
+	std::streambuf * buffer = is.rdbuf();
+	traits::int_type c = buffer->sgetc();
+	while (!traits::eq_int_type(c, traits::eof()) && !isLetter(traits::to_char_type(c))) {
+		c = buffer->snextc();
 	}
 
 	std::string newword;
-
-	while (is.good())
-	{
-		char x = is.peek();
-		if(isalpha(x)) {
-			newword.push_back(x);
-			is.ignore();
-		} else {
-			break;
-		}
+	while (!traits::eq_int_type(c, traits::eof()) && isLetter(traits::to_char_type(c))) {
+		newword.push_back(traits::to_char_type(c));
+		c = buffer->snextc();
 	}
 
+	std::ios::iostate state = std::ios::goodbit;
+	if (traits::eq_int_type(c, traits::eof())) {
+		state |= std::ios::eofbit;
+	}
 	if(!newword.empty()) {
-		try {
-			word = Word(newword);
-		} catch (std::invalid_argument const &) {
-			is.setstate(std::ios::failbit);
-		}
-
+		word = Word::fromLetters(newword);
 	} else {
-		is.setstate(std::ios::failbit);
+		state |= std::ios::failbit;
 	}
+	is.setstate(state);
 
 	return is;
 }
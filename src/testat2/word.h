@@ -1,21 +1,40 @@
 #ifndef WORD_C_
 #define WORD_C_
 
+#include "utf8.h"
+
 #include <string>
+#include <string_view>
 
 namespace text {
 
 class Word {
 	std::string word{"default"};
+	// lower case copy of word, computed once so that comparisons do not allocate
+	std::string key{"default"};
 public:
 	Word() = default;
 	// does block unwanted casting
 	explicit Word(std::string const input);
+	// with textEncoding::utf8 any Unicode letters are accepted
+	Word(std::string const input, textEncoding encoding);
 	explicit Word(std::istream & in);
 	bool operator <(Word const & w) const;
 	bool operator ==(Word const & w) const;
 	void read(std::istream & in);
 
+	// creates a word from a non-empty run of letters as found by the
+	// tokenizer, without validating it again
+	static Word fromLetters(std::string_view letters, textEncoding encoding = textEncoding::ascii);
+
+	std::string const & text() const {
+		return word;
+	}
+	// the lower case key the comparisons are based on
+	std::string const & folded() const {
+		return key;
+	}
+
 	// a friend has access to private members
 	friend std::istream & operator>>(std::istream & is, Word & word);
 	friend std::ostream & operator<<(std::ostream & os, Word const & word);
@@ -0,0 +1,62 @@
+#include "wordPool.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace text {
+
+wordId wordPool::intern(std::string_view s) {
+	auto found = ids.find(s);
+	if (found != ids.end()) {
+		return found->second;
+	}
+	char * stored = allocate(s.size());
+	std::copy(s.begin(), s.end(), stored);
+	std::string_view view(stored, s.size());
+	wordId id = strings.size();
+	strings.push_back(view);
+	ids.emplace(view, id);
+	return id;
+}
+
+std::vector<std::uint32_t> wordPool::collationRanks() const {
+	std::vector<wordId> order(strings.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::sort(order.begin(), order.end(), [this](wordId lhs, wordId rhs) {
+		return strings[lhs] < strings[rhs];
+	});
+	std::vector<std::uint32_t> ranks(strings.size());
+	for (std::uint32_t rank = 0; rank < order.size(); rank++) {
+		ranks[order[rank]] = rank;
+	}
+	return ranks;
+}
+
+std::size_t wordPool::memoryUsage() const {
+	// a hash node holds the view, the id and the next pointer
+	std::size_t perString = sizeof(std::string_view) + sizeof(std::string_view) + 2 * sizeof(void *);
+	return reserved + strings.size() * perString;
+}
+
+char * wordPool::allocate(std::size_t length) {
+	if (length > left) {
+		if (length > maxBlockSize / 4) {
+			// large strings get a block of their own, the current one stays in use
+			blocks.emplace_back(new char[length]);
+			reserved += length;
+			return blocks.back().get();
+		}
+		std::size_t size = std::max(nextBlockSize, length);
+		nextBlockSize = std::min(2 * nextBlockSize, maxBlockSize);
+		blocks.emplace_back(new char[size]);
+		reserved += size;
+		current = blocks.back().get();
+		left = size;
+	}
+	char * result = current;
+	current += length;
+	left -= length;
+	return result;
+}
+
+}
@@ -0,0 +1,62 @@
+#ifndef SRC_WORDPOOL_H_
+#define SRC_WORDPOOL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace text {
+
+// handle of a string interned in a wordPool
+using wordId = std::uint32_t;
+
+// Stores every distinct string once and hands out dense 32 bit ids in the
+// order the strings were first seen. The characters live in an arena of
+// blocks, each twice as large as the previous one up to 64 KiB, so the
+// views returned stay valid for the lifetime of the pool, also when it is
+// moved.
+class wordPool {
+	static constexpr std::size_t initialBlockSize = 1024;
+	static constexpr std::size_t maxBlockSize = 64 * 1024;
+
+	std::vector<std::unique_ptr<char[]>> blocks{};
+	char * current{nullptr};
+	std::size_t left{0};
+	std::size_t nextBlockSize{initialBlockSize};
+	std::vector<std::string_view> strings{};
+	std::unordered_map<std::string_view, wordId> ids{};
+	// bytes of all blocks
+	std::size_t reserved{0};
+public:
+	wordPool() = default;
+	wordPool(wordPool &&) = default;
+	wordPool & operator=(wordPool &&) = default;
+
+	// the id of s, which is added if it is new
+	wordId intern(std::string_view s);
+
+	std::string_view operator[](wordId id) const {
+		return strings[id];
+	}
+	std::size_t size() const {
+		return strings.size();
+	}
+
+	// The collation rank of every id, indexed by id: the position of the
+	// string among all strings of the pool in byte order. Comparing ranks
+	// compares the strings like std::string::compare.
+	std::vector<std::uint32_t> collationRanks() const;
+
+	// approximate heap memory held by the pool
+	std::size_t memoryUsage() const;
+
+private:
+	char * allocate(std::size_t length);
+};
+
+}
+
+#endif /* SRC_WORDPOOL_H_ */
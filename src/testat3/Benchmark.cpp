@@ -0,0 +1,286 @@
+#include "indexableSet.h"
+#include "flatIndexableSet.h"
+#include "concurrentIndexableSet.h"
+#include "mappedIndexableSet.h"
+#include "nodeArena.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory_resource>
+#include <mutex>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Micro benchmarks for the indexableSet variants. Build with optimisation,
+// e.g. g++ -std=c++20 -O2 -pthread Benchmark.cpp nodeArena.cpp
+// mappedIndexableSet.cpp. The optional arguments are the element count for
+// the read benchmarks, the number of inserts for the allocator benchmark
+// and the maximal number of reader threads for the concurrency benchmark.
+
+namespace {
+
+template <typename FUNCTION>
+double measure(FUNCTION && function) {
+	auto start = std::chrono::steady_clock::now();
+	function();
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	return elapsed.count();
+}
+
+void report(std::string const & name, double milliseconds) {
+	std::cout << std::left << std::setw(48) << name << std::right << std::setw(12) << std::fixed << std::setprecision(2) << milliseconds << " ms\n";
+}
+
+// keeps the optimiser from dropping the measured work
+volatile long long sink{};
+
+std::vector<int> randomValues(std::size_t n, unsigned seed) {
+	std::mt19937 rng{seed};
+	std::vector<int> values(n);
+	for (auto & value : values) {
+		value = static_cast<int>(rng());
+	}
+	return values;
+}
+
+// the previous std::set based implementation that steps to index i
+template <typename T>
+struct setIndexableSet : std::set<T> {
+	using std::set<T>::set;
+	T const & operator[](int i) const {
+		auto itr = this->begin();
+		std::advance(itr, i < 0 ? static_cast<int>(this->size()) + i : i);
+		return *itr;
+	}
+};
+
+template <typename SET>
+void benchmarkReadMostly(std::string const & name, std::vector<int> const & values, std::vector<int> const & probes, std::size_t indexCount) {
+	SET set{};
+	report(name + " build", measure([&] {
+		set = SET(values.begin(), values.end());
+	}));
+	report(name + " iterate", measure([&] {
+		long long sum{};
+		for (int value : set) {
+			sum += value;
+		}
+		sink = sum;
+	}));
+	report(name + " find", measure([&] {
+		long long found{};
+		for (int probe : probes) {
+			found += set.count(probe);
+		}
+		sink = found;
+	}));
+	int size = set.size();
+	report(name + " operator[] x" + std::to_string(indexCount), measure([&] {
+		long long sum{};
+		for (std::size_t i = 0; i < indexCount; i++) {
+			sum += set[static_cast<int>((i * 7919) % size)];
+		}
+		sink = sum;
+	}));
+}
+
+void benchmarkFlatIndexableSet(std::size_t n) {
+	std::cout << "--- flat_indexableSet vs. indexableSet, n = " << n << " ---\n";
+	auto values = randomValues(n, 1);
+	auto probes = randomValues(n, 2);
+	benchmarkReadMostly<setIndexableSet<int>>("std::set (stepping)", values, probes, 100);
+	benchmarkReadMostly<indexableSet<int>>("indexableSet", values, probes, n);
+	benchmarkReadMostly<flat_indexableSet<int>>("flat_indexableSet", values, probes, n);
+}
+
+template <typename SET>
+void benchmarkInsertBuild(std::string const & name, std::vector<int> const & values, SET set) {
+	report(name + " build", measure([&] {
+		for (int value : values) {
+			set.insert(value);
+		}
+	}));
+	sink = set.size();
+	report(name + " destroy", measure([&] {
+		set.clear();
+	}));
+}
+
+void benchmarkAllocators(std::size_t n) {
+	std::cout << "--- indexableSet node allocation, " << n << " inserts ---\n";
+	auto values = randomValues(n, 3);
+	benchmarkInsertBuild("std::allocator", values, indexableSet<int>{});
+	{
+		std::pmr::monotonic_buffer_resource monotonic{};
+		benchmarkInsertBuild("std::pmr::monotonic_buffer_resource", values, pmr_indexableSet<int>{&monotonic});
+	}
+	nodeArena arena{};
+	benchmarkInsertBuild("nodeArena", values, pmr_indexableSet<int>{&arena});
+	report("nodeArena release", measure([&] {
+		arena.release();
+	}));
+}
+
+void benchmarkSetAlgebra(std::size_t n) {
+	std::cout << "--- indexableSet sorted build and set algebra, n = " << n << " ---\n";
+	auto values = randomValues(n, 4);
+	std::sort(values.begin(), values.end());
+	values.erase(std::unique(values.begin(), values.end()), values.end());
+	auto others = randomValues(n, 5);
+	std::sort(others.begin(), others.end());
+	others.erase(std::unique(others.begin(), others.end()), others.end());
+
+	indexableSet<int> lhs{}, rhs{};
+	report("range constructor (n inserts)", measure([&] {
+		lhs = indexableSet<int>(values.begin(), values.end());
+	}));
+	report("sorted_unique constructor", measure([&] {
+		lhs = indexableSet<int>(sorted_unique, values.begin(), values.end());
+	}));
+	rhs = indexableSet<int>(sorted_unique, others.begin(), others.end());
+
+	report("std::set_union into inserter", measure([&] {
+		indexableSet<int> result{};
+		std::set_union(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::inserter(result, result.end()));
+		sink = result.size();
+	}));
+	std::vector<unsigned> threadCounts{1};
+	if(std::thread::hardware_concurrency() > 1) {
+		threadCounts.push_back(std::thread::hardware_concurrency());
+	}
+	for(unsigned t : threadCounts) {
+		report("set_union, threads = " + std::to_string(t), measure([&] {
+			sink = lhs.set_union(rhs, t).size();
+		}));
+		report("set_intersection, threads = " + std::to_string(t), measure([&] {
+			sink = lhs.set_intersection(rhs, t).size();
+		}));
+		report("set_difference, threads = " + std::to_string(t), measure([&] {
+			sink = lhs.set_difference(rhs, t).size();
+		}));
+	}
+}
+
+// runs readers threads doing positional lookups while one writer inserts
+// every millisecond, returns lookups per second over all readers
+template <typename SETUP_READER, typename WRITE>
+double readerThroughput(unsigned readers, SETUP_READER setupReader, WRITE write) {
+	std::atomic<bool> running{true};
+	std::atomic<long long> lookups{};
+	std::vector<std::thread> threads{};
+	for(unsigned r = 0; r < readers; r++) {
+		threads.emplace_back([&, r] {
+			auto lookup = setupReader();
+			long long count{};
+			long long sum{};
+			for(unsigned i = r; running.load(std::memory_order_relaxed); i += 7919) {
+				sum += lookup(i);
+				count++;
+			}
+			sink = sum;
+			lookups += count;
+		});
+	}
+	std::thread writer{[&] {
+		for(int i = 0; running.load(); i++) {
+			write(i);
+			std::this_thread::sleep_for(std::chrono::milliseconds{1});
+		}
+	}};
+	auto duration = std::chrono::milliseconds{500};
+	std::this_thread::sleep_for(duration);
+	running = false;
+	for(auto & thread : threads) {
+		thread.join();
+	}
+	writer.join();
+	return lookups * 1000.0 / duration.count();
+}
+
+void benchmarkConcurrentReaders(std::size_t n, unsigned maxReaders) {
+	std::cout << "--- concurrent positional lookups (lookups/s), n = " << n << " ---\n";
+	auto values = randomValues(n, 6);
+	for(unsigned readers = 1; readers <= maxReaders; readers *= 2) {
+		std::mutex mutex{};
+		indexableSet<int> locked(values.begin(), values.end());
+		double lockedRate = readerThroughput(readers, [&] {
+			return [&](unsigned i) {
+				std::lock_guard<std::mutex> lock{mutex};
+				return locked[i % locked.size()];
+			};
+		}, [&](int i) {
+			std::lock_guard<std::mutex> lock{mutex};
+			locked.insert(i);
+		});
+
+		concurrentIndexableSet<int> shared(maxReaders + 1);
+		shared.insert(values.begin(), values.end());
+		double snapshotRate = readerThroughput(readers, [&] {
+			return [reader = std::make_shared<concurrentIndexableSet<int>::reader>(shared.registerReader())](unsigned i) {
+				auto snapshot = reader->pin();
+				return (*snapshot)[i % snapshot->size()];
+			};
+		}, [&](int i) {
+			shared.insert(i);
+		});
+
+		std::cout << std::setw(3) << readers << " readers: mutex + indexableSet " << std::setw(14) << std::fixed << std::setprecision(0) << lockedRate
+				<< "   concurrentIndexableSet " << std::setw(14) << snapshotRate << '\n';
+	}
+}
+
+void benchmarkMappedSnapshot(std::size_t n) {
+	std::cout << "--- indexableSet<std::string> startup, n = " << n << " ---\n";
+	auto directory = std::filesystem::temp_directory_path();
+	auto textPath = (directory / "indexableSet_benchmark.txt").string();
+	auto snapshotPath = (directory / "indexableSet_benchmark.snapshot").string();
+	{
+		std::ofstream text{textPath};
+		for(int value : randomValues(n, 7)) {
+			text << "key" << value << '\n';
+		}
+	}
+	indexableSet<std::string> parsed{};
+	report("parse text into indexableSet", measure([&] {
+		std::ifstream text{textPath};
+		std::string line{};
+		while(std::getline(text, line)) {
+			parsed.insert(line);
+		}
+	}));
+	report("writeSnapshot", measure([&] {
+		writeSnapshot(parsed, snapshotPath);
+	}));
+	report("open mappedIndexableSet + 1000 lookups", measure([&] {
+		mappedIndexableSet<std::string> mapped{snapshotPath};
+		std::size_t length{};
+		for(int i = 0; i < 1000; i++) {
+			length += mapped[-i - 1].size();
+		}
+		sink = length;
+	}));
+	std::filesystem::remove(textPath);
+	std::filesystem::remove(snapshotPath);
+}
+
+}
+
+int main(int argc, char const *argv[]) {
+	std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+	std::size_t inserts = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10000000;
+	benchmarkFlatIndexableSet(n);
+	benchmarkAllocators(inserts);
+	benchmarkSetAlgebra(n);
+	unsigned readers = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : std::max(1u, std::thread::hardware_concurrency());
+	benchmarkConcurrentReaders(n, readers);
+	benchmarkMappedSnapshot(n);
+}
@@ -1,4 +1,8 @@
 #include "indexableSet.h"
+#include "flatIndexableSet.h"
+#include "concurrentIndexableSet.h"
+#include "mappedIndexableSet.h"
+#include "nodeArena.h"
 #include "cute.h"
 #include "ide_listener.h"
 #include "xml_listener.h"
@@ -6,8 +10,14 @@
 
 #include <algorithm>
 #include <cctype>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
 
 #include <string>
+#include <thread>
+#include <vector>
 // Tests written with D.H.
 
 
@@ -75,6 +85,279 @@ void test_indexableSet_with_caselessCompare(){
 	ASSERT_EQUAL(stringSet[-1], "c");
 }
 
+void test_index_access_on_large_set(){
+	indexableSet<int> set{};
+	for(int i = 0; i < 10000; i++) {
+		set.insert(9999 - i);
+	}
+	ASSERT_EQUAL(set[4711], 4711);
+	ASSERT_EQUAL(set[-1], 9999);
+	ASSERT_EQUAL(set.at(-10000), 0);
+}
+
+void test_index_access_after_erase(){
+	indexableSet<int> set{1,2,3,4,5,6,7,8,9,10};
+	set.erase(3);
+	set.erase(set.begin());
+	ASSERT_EQUAL(set.front(), 2);
+	ASSERT_EQUAL(set[1], 4);
+	ASSERT_EQUAL(set[-8], 2);
+	ASSERT_THROWS(set[8], std::out_of_range);
+}
+
+void test_iteration_is_sorted(){
+	indexableSet<int> set{5,3,9,1,7};
+	ASSERT(std::is_sorted(set.begin(), set.end()));
+	ASSERT_EQUAL(*set.rbegin(), 9);
+}
+
+void test_flat_indexableSet_index_access(){
+	flat_indexableSet<int> set{10,9,8,7,6,5,4,3,2,1};
+	ASSERT_EQUAL(set[8], 9);
+	ASSERT_EQUAL(set.at(-8), 3);
+	ASSERT_EQUAL(set.front(), 1);
+	ASSERT_EQUAL(set.back(), 10);
+	ASSERT_THROWS(set[10], std::out_of_range);
+	ASSERT_THROWS(set.at(-11), std::out_of_range);
+}
+
+void test_flat_indexableSet_bulk_insert_deduplicates(){
+	flat_indexableSet<int> set{5,1,3};
+	std::vector<int> values{4,3,2,4,6,1};
+	set.insert(values.begin(), values.end());
+	ASSERT_EQUAL(set.size(), 6);
+	ASSERT(std::is_sorted(set.begin(), set.end()));
+}
+
+void test_flat_indexableSet_with_caselessCompare(){
+	flat_indexableSet<std::string, caselessCompare> stringSet{"c", "bb", "bc", "ac", "ab", "aa", "AA"};
+	ASSERT_EQUAL(stringSet.size(), 6);
+	ASSERT_EQUAL(stringSet[0], "aa");
+	ASSERT_EQUAL(stringSet[-1], "c");
+	ASSERT(stringSet.contains("BB"));
+}
+
+void test_rank_and_index_of(){
+	indexableSet<int> set{10,20,30,40,50};
+	ASSERT_EQUAL(set.index_of(40), 3);
+	ASSERT_EQUAL(set.rank(35), 3);
+	ASSERT_EQUAL(set.rank(5), 0);
+	ASSERT_EQUAL(set.rank(60), 5);
+	ASSERT_THROWS(set.index_of(35), std::out_of_range);
+}
+
+void test_slice_with_negative_bounds(){
+	indexableSet<int> set{1,2,3,4,5,6,7,8,9,10};
+	auto slice = set.slice(2, -3);
+	ASSERT_EQUAL(slice.size(), 5);
+	ASSERT_EQUAL(slice.front(), 3);
+	ASSERT_EQUAL(slice[-1], 7);
+	ASSERT_EQUAL(std::accumulate(slice.begin(), slice.end(), 0), 25);
+	ASSERT_EQUAL(slice.slice(-2, 5)[0], 6);
+	ASSERT_THROWS(slice[5], std::out_of_range);
+}
+
+void test_empty_and_invalid_slice(){
+	flat_indexableSet<int> set{1,2,3};
+	ASSERT(set.slice(2, 1).empty());
+	ASSERT_EQUAL(set.slice(0, 3).size(), 3);
+	ASSERT_THROWS(set.slice(0, 4), std::out_of_range);
+	ASSERT_THROWS(set.slice(-4, 2), std::out_of_range);
+}
+
+void test_pmr_indexableSet_in_nodeArena(){
+	nodeArena arena{};
+	pmr_indexableSet<int> set{&arena};
+	for(int i = 0; i < 1000; i++) {
+		set.insert(i % 2 ? i : -i);
+	}
+	for(int i = 0; i < 500; i++) {
+		set.erase(-2 * i);
+	}
+	ASSERT_EQUAL(set.size(), 500);
+	ASSERT_EQUAL(set.front(), 1);
+	ASSERT_EQUAL(set[-1], 999);
+	ASSERT(set.get_allocator().resource() == &arena);
+}
+
+void test_pmr_indexableSet_copy_into_other_arena(){
+	nodeArena first{}, second{};
+	pmr_indexableSet<std::string> set{{"b", "a", "c"}, &first};
+	pmr_indexableSet<std::string> copy{set, &second};
+	set.clear();
+	first.release();
+	ASSERT_EQUAL(copy[1], "b");
+	ASSERT(copy.get_allocator().resource() == &second);
+}
+
+void test_sorted_unique_construction(){
+	std::vector<int> values{1,2,3,4,5,6,7,8,9,10};
+	indexableSet<int> set{sorted_unique, values.begin(), values.end()};
+	ASSERT_EQUAL(set.size(), 10);
+	ASSERT_EQUAL(set[4], 5);
+	ASSERT_EQUAL(set.back(), 10);
+	set.insert(0);
+	ASSERT_EQUAL(set.front(), 0);
+}
+
+void test_set_algebra(){
+	indexableSet<int> lhs{1,2,3,4,5,6};
+	indexableSet<int> rhs{4,5,6,7,8};
+	ASSERT_EQUAL(lhs.set_union(rhs), (indexableSet<int>{1,2,3,4,5,6,7,8}));
+	ASSERT_EQUAL(lhs.set_intersection(rhs), (indexableSet<int>{4,5,6}));
+	ASSERT_EQUAL(lhs.set_difference(rhs), (indexableSet<int>{1,2,3}));
+	ASSERT_EQUAL(rhs.set_difference(lhs), (indexableSet<int>{7,8}));
+}
+
+void test_parallel_set_algebra_matches_sequential(){
+	indexableSet<int> lhs{}, rhs{};
+	for(int i = 0; i < 200000; i++) {
+		lhs.insert(i * 3);
+		rhs.insert(i * 5);
+	}
+	ASSERT_EQUAL(lhs.set_union(rhs, 4), lhs.set_union(rhs));
+	ASSERT_EQUAL(lhs.set_intersection(rhs, 4), lhs.set_intersection(rhs));
+	ASSERT_EQUAL(rhs.set_difference(lhs, 4), rhs.set_difference(lhs));
+}
+
+// throws when comparing throwAt with itself, which set algebra does for common keys
+int throwAt{-1};
+struct throwingCompare {
+	bool operator()(int lhs, int rhs) const {
+		if(lhs == throwAt && rhs == throwAt) {
+			throw std::runtime_error("comparison failed");
+		}
+		return lhs < rhs;
+	}
+};
+
+void test_parallel_set_algebra_propagates_exceptions(){
+	indexableSet<int, throwingCompare> lhs{}, rhs{};
+	for(int i = 0; i < 200000; i++) {
+		lhs.insert(i * 3);
+		rhs.insert(i * 5);
+	}
+	// in the first part, merged by the calling thread, and in the last one
+	for(int key : {15, 450000}) {
+		throwAt = key;
+		ASSERT_THROWS(lhs.set_union(rhs, 4), std::runtime_error);
+		ASSERT_THROWS(lhs.set_intersection(rhs, 4), std::runtime_error);
+	}
+	throwAt = -1;
+}
+
+void test_concurrentIndexableSet_reader_access(){
+	concurrentIndexableSet<int> set{1,2,3,4,5,6,7,8,9,10};
+	auto reader = set.registerReader();
+	ASSERT_EQUAL(reader[8], 9);
+	ASSERT_EQUAL(reader.at(-8), 3);
+	ASSERT_EQUAL(reader.front(), 1);
+	ASSERT_EQUAL(reader.back(), 10);
+	ASSERT_THROWS(reader[10], std::out_of_range);
+}
+
+void test_concurrentIndexableSet_snapshot_is_stable(){
+	concurrentIndexableSet<int> set{1,2,3};
+	auto reader = set.registerReader();
+	auto snapshot = reader.pin();
+	set.insert(0);
+	set.erase(3);
+	ASSERT_EQUAL(snapshot->front(), 1);
+	ASSERT_EQUAL(snapshot->size(), 3);
+	ASSERT_EQUAL(reader.front(), 0);
+	ASSERT_EQUAL(reader.back(), 2);
+}
+
+void test_concurrentIndexableSet_too_many_readers(){
+	concurrentIndexableSet<int> set(2);
+	auto first = set.registerReader();
+	auto second = set.registerReader();
+	ASSERT_THROWS(set.registerReader(), std::length_error);
+}
+
+void test_concurrentIndexableSet_readers_during_writes(){
+	concurrentIndexableSet<int> set{0};
+	std::vector<std::thread> readers{};
+	std::atomic<bool> sorted{true};
+	for(int r = 0; r < 4; r++) {
+		readers.emplace_back([&] {
+			auto reader = set.registerReader();
+			for(int i = 0; i < 2000; i++) {
+				auto snapshot = reader.pin();
+				if(snapshot->front() != 0 || snapshot->back() != static_cast<int>(snapshot->size()) - 1) {
+					sorted = false;
+				}
+			}
+		});
+	}
+	for(int i = 1; i < 500; i++) {
+		set.insert(i);
+	}
+	for(auto & reader : readers) {
+		reader.join();
+	}
+	ASSERT(sorted);
+	ASSERT_EQUAL(set.registerReader().size(), 500);
+}
+
+std::string snapshotPath(std::string const & name){
+	return (std::filesystem::temp_directory_path() / name).string();
+}
+
+void test_mapped_snapshot_of_ints(){
+	indexableSet<int> set{1,2,3,4,5,6,7,8,9,10};
+	auto path = snapshotPath("indexableSet_ints.snapshot");
+	writeSnapshot(set, path);
+	mappedIndexableSet<int> mapped{path};
+	ASSERT_EQUAL(mapped.size(), 10);
+	ASSERT_EQUAL(mapped[8], 9);
+	ASSERT_EQUAL(mapped.at(-8), 3);
+	ASSERT_EQUAL(mapped.front(), 1);
+	ASSERT_EQUAL(mapped.back(), 10);
+	ASSERT_THROWS(mapped[10], std::out_of_range);
+	ASSERT(mapped.contains(7));
+	std::filesystem::remove(path);
+}
+
+void test_mapped_snapshot_of_strings(){
+	indexableSet<std::string> set{"pear", "apple", "", "banana"};
+	auto path = snapshotPath("indexableSet_strings.snapshot");
+	writeSnapshot(set, path);
+	mappedIndexableSet<std::string> mapped{path};
+	ASSERT_EQUAL(mapped.size(), 4);
+	ASSERT_EQUAL(mapped[0], "");
+	ASSERT_EQUAL(mapped[1], "apple");
+	ASSERT_EQUAL(mapped[-1], "pear");
+	ASSERT(mapped.contains("banana"));
+	ASSERT(!mapped.contains("cherry"));
+	ASSERT_THROWS(mappedIndexableSet<int>{path}, std::runtime_error);
+	std::filesystem::remove(path);
+}
+
+void test_mapped_snapshot_with_corrupt_offsets(){
+	indexableSet<std::string> set{"pear", "apple", "banana"};
+	auto path = snapshotPath("indexableSet_corrupt.snapshot");
+	writeSnapshot(set, path);
+	auto corruptOffset = [&](std::size_t index, std::uint64_t value) {
+		std::fstream file{path, std::ios::in | std::ios::out | std::ios::binary};
+		file.seekp(sizeof(snapshotHeader) + index * sizeof(std::uint64_t));
+		file.write(reinterpret_cast<char const *>(&value), sizeof(value));
+	};
+	// offsets are 0 5 11 15, a decreasing one in the middle is found on access
+	corruptOffset(1, 12);
+	mappedIndexableSet<std::string> decreasing{path};
+	ASSERT_EQUAL(decreasing[2], "pear");
+	ASSERT_THROWS(decreasing[1], std::runtime_error);
+	corruptOffset(1, 16);
+	mappedIndexableSet<std::string> beyond{path};
+	ASSERT_THROWS(beyond[0], std::runtime_error);
+	corruptOffset(1, 5);
+	corruptOffset(0, 1);
+	ASSERT_THROWS(mappedIndexableSet<std::string>{path}, std::runtime_error);
+	corruptOffset(0, 0);
+	ASSERT_EQUAL(mappedIndexableSet<std::string>{path}[1], "banana");
+	std::filesystem::remove(path);
+}
 
 bool runAllTests(int argc, char const *argv[]) {
 	cute::suite s { };
@@ -89,6 +372,28 @@ bool runAllTests(int argc, char const *argv[]) {
 	s.push_back(CUTE(test_front_member_function));
 	s.push_back(CUTE(test_back_member_function));
 	s.push_back(CUTE(test_indexableSet_with_caselessCompare));
+	s.push_back(CUTE(test_index_access_on_large_set));
+	s.push_back(CUTE(test_index_access_after_erase));
+	s.push_back(CUTE(test_iteration_is_sorted));
+	s.push_back(CUTE(test_flat_indexableSet_index_access));
+	s.push_back(CUTE(test_flat_indexableSet_bulk_insert_deduplicates));
+	s.push_back(CUTE(test_flat_indexableSet_with_caselessCompare));
+	s.push_back(CUTE(test_rank_and_index_of));
+	s.push_back(CUTE(test_slice_with_negative_bounds));
+	s.push_back(CUTE(test_empty_and_invalid_slice));
+	s.push_back(CUTE(test_pmr_indexableSet_in_nodeArena));
+	s.push_back(CUTE(test_pmr_indexableSet_copy_into_other_arena));
+	s.push_back(CUTE(test_sorted_unique_construction));
+	s.push_back(CUTE(test_set_algebra));
+	s.push_back(CUTE(test_parallel_set_algebra_matches_sequential));
+	s.push_back(CUTE(test_parallel_set_algebra_propagates_exceptions));
+	s.push_back(CUTE(test_concurrentIndexableSet_reader_access));
+	s.push_back(CUTE(test_concurrentIndexableSet_snapshot_is_stable));
+	s.push_back(CUTE(test_concurrentIndexableSet_too_many_readers));
+	s.push_back(CUTE(test_concurrentIndexableSet_readers_during_writes));
+	s.push_back(CUTE(test_mapped_snapshot_of_ints));
+	s.push_back(CUTE(test_mapped_snapshot_of_strings));
+	s.push_back(CUTE(test_mapped_snapshot_with_corrupt_offsets));
 	cute::xml_file_opener xmlfile(argc, argv);
 	cute::xml_listener<cute::ide_listener<>> lis(xmlfile.out);
 	auto runner = cute::makeRunner(lis, argc, argv);
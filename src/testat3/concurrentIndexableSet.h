@@ -0,0 +1,206 @@
+#ifndef SRC_CONCURRENTINDEXABLESET_H_
+#define SRC_CONCURRENTINDEXABLESET_H_
+
+#include "flatIndexableSet.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// indexableSet for many reader threads and occasional writers. The contents
+// are an immutable flat_indexableSet version. A write copies the current
+// version, modifies the copy and publishes it with one atomic exchange.
+// Readers pin the current version with a fixed number of atomic operations
+// and never wait for writers or other readers. Replaced versions are freed
+// once no reader pinned before the exchange is still pinned (epoch based
+// reclamation). Writers are serialised by a mutex and pay O(n) per write.
+template <typename T, typename COMPARE=std::less<T>>
+class concurrentIndexableSet {
+public:
+	using version = flat_indexableSet<T, COMPARE>;
+	using value_type = T;
+	using size_type = typename version::size_type;
+
+private:
+	static constexpr std::uint64_t idle = std::numeric_limits<std::uint64_t>::max();
+
+	struct alignas(64) readerSlot {
+		std::atomic<std::uint64_t> epoch{idle};
+		std::atomic<bool> used{false};
+		// only touched by the thread owning the slot
+		unsigned pins{0};
+	};
+
+	std::atomic<version const *> current;
+	std::atomic<std::uint64_t> epoch{0};
+	std::unique_ptr<readerSlot[]> slots;
+	std::size_t slotCount;
+	std::mutex writerMutex{};
+	std::vector<std::pair<std::uint64_t, version const *>> retired{};
+
+public:
+	class reader;
+
+	// Pinned version, valid until the snapshot is destroyed. Must not outlive
+	// the reader it was taken from.
+	class snapshot {
+		friend class reader;
+		readerSlot * slot;
+		version const * data;
+
+		snapshot(readerSlot * slot, version const * data) : slot{slot}, data{data} {}
+	public:
+		snapshot(snapshot && other) noexcept : slot{std::exchange(other.slot, nullptr)}, data{other.data} {}
+		snapshot(snapshot const &) = delete;
+		snapshot & operator=(snapshot const &) = delete;
+		snapshot & operator=(snapshot &&) = delete;
+		~snapshot() {
+			if (slot && --slot->pins == 0) {
+				slot->epoch.store(idle);
+			}
+		}
+
+		version const & operator*() const {
+			return *data;
+		}
+		version const * operator->() const {
+			return data;
+		}
+	};
+
+	// Per thread read handle owning one reader slot. The accessors pin the
+	// current version for the duration of the call and return copies.
+	class reader {
+		friend class concurrentIndexableSet;
+		concurrentIndexableSet const * set;
+		readerSlot * slot;
+
+		reader(concurrentIndexableSet const * set, readerSlot * slot) : set{set}, slot{slot} {}
+	public:
+		reader(reader && other) noexcept : set{other.set}, slot{std::exchange(other.slot, nullptr)} {}
+		reader(reader const &) = delete;
+		reader & operator=(reader const &) = delete;
+		reader & operator=(reader &&) = delete;
+		~reader() {
+			if (slot) {
+				slot->used.store(false);
+			}
+		}
+
+		snapshot pin() const {
+			if (slot->pins++ == 0) {
+				slot->epoch.store(set->epoch.load());
+			}
+			return snapshot{slot, set->current.load()};
+		}
+
+		T operator[] (signed int i) const {
+			return (*pin())[i];
+		}
+		T at(int i) const {
+			return pin()->at(i);
+		}
+		T front() const {
+			return pin()->front();
+		}
+		T back() const {
+			return pin()->back();
+		}
+		size_type size() const {
+			return pin()->size();
+		}
+		bool contains(T const & value) const {
+			return pin()->contains(value);
+		}
+	};
+
+	explicit concurrentIndexableSet(std::size_t maxReaders = 64)
+		: current{new version{}}, slots{new readerSlot[maxReaders]}, slotCount{maxReaders} {}
+
+	concurrentIndexableSet(std::initializer_list<T> values, std::size_t maxReaders = 64)
+		: current{new version(values)}, slots{new readerSlot[maxReaders]}, slotCount{maxReaders} {}
+
+	concurrentIndexableSet(concurrentIndexableSet const &) = delete;
+	concurrentIndexableSet & operator=(concurrentIndexableSet const &) = delete;
+
+	// all readers must be gone
+	~concurrentIndexableSet() {
+		for (auto const & entry : retired) {
+			delete entry.second;
+		}
+		delete current.load();
+	}
+
+	// claims a reader slot, throws std::length_error if all are in use
+	reader registerReader() const {
+		for (std::size_t i = 0; i < slotCount; i++) {
+			bool expected = false;
+			if (slots[i].used.compare_exchange_strong(expected, true)) {
+				return reader{this, &slots[i]};
+			}
+		}
+		throw std::length_error("Too many readers!");
+	}
+
+	bool insert(T const & value) {
+		bool inserted = false;
+		update([&](version & next) {
+			inserted = next.insert(value).second;
+		});
+		return inserted;
+	}
+
+	template <typename ITERATOR>
+	void insert(ITERATOR first, ITERATOR last) {
+		update([&](version & next) {
+			next.insert(first, last);
+		});
+	}
+
+	size_type erase(T const & value) {
+		size_type erased = 0;
+		update([&](version & next) {
+			erased = next.erase(value);
+		});
+		return erased;
+	}
+
+	// applies modify to a copy of the current version and publishes it
+	template <typename FUNCTION>
+	void update(FUNCTION modify) {
+		std::lock_guard<std::mutex> lock{writerMutex};
+		auto next = std::make_unique<version>(*current.load());
+		modify(*next);
+		version const * old = current.exchange(next.release());
+		retired.emplace_back(epoch.fetch_add(1) + 1, old);
+		reclaim();
+	}
+
+private:
+	// a version retired at epoch e is unreachable once every pinned reader
+	// announced an epoch >= e, those readers loaded current after the exchange
+	void reclaim() {
+		std::uint64_t oldestPin = idle;
+		for (std::size_t i = 0; i < slotCount; i++) {
+			oldestPin = std::min(oldestPin, slots[i].epoch.load());
+		}
+		auto stillVisible = std::partition(retired.begin(), retired.end(), [oldestPin](auto const & entry) {
+			return entry.first > oldestPin;
+		});
+		for (auto it = stillVisible; it != retired.end(); ++it) {
+			delete it->second;
+		}
+		retired.erase(stillVisible, retired.end());
+	}
+};
+
+#endif /* SRC_CONCURRENTINDEXABLESET_H_ */
@@ -0,0 +1,274 @@
+#ifndef SRC_FLATINDEXABLESET_H_
+#define SRC_FLATINDEXABLESET_H_
+
+#include "indexableSlice.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Sorted vector with the interface of indexableSet. Elements are stored
+// contiguously, indexing is O(1) and lookup is a binary search. Single
+// inserts and erases shift the tail and are O(n), so the type is meant for
+// sets that are built once (preferably with the bulk insert) and then read.
+template <typename T, typename COMPARE=std::less<T>>
+class flat_indexableSet {
+	using container = std::vector<T>;
+
+	container elements{};
+	COMPARE compare{};
+
+public:
+	using key_type = T;
+	using value_type = T;
+	using key_compare = COMPARE;
+	using value_compare = COMPARE;
+	using size_type = typename container::size_type;
+	using difference_type = typename container::difference_type;
+	using reference = value_type &;
+	using const_reference = value_type const &;
+	using pointer = value_type *;
+	using const_pointer = value_type const *;
+	using iterator = typename container::const_iterator;
+	using const_iterator = typename container::const_iterator;
+	using reverse_iterator = typename container::const_reverse_iterator;
+	using const_reverse_iterator = typename container::const_reverse_iterator;
+
+	flat_indexableSet() = default;
+
+	explicit flat_indexableSet(COMPARE const & comp) : compare{comp} {}
+
+	template <typename ITERATOR>
+	flat_indexableSet(ITERATOR first, ITERATOR last, COMPARE const & comp = COMPARE{}) : compare{comp} {
+		insert(first, last);
+	}
+
+	flat_indexableSet(std::initializer_list<T> values, COMPARE const & comp = COMPARE{})
+		: flat_indexableSet(values.begin(), values.end(), comp) {}
+
+	const_iterator begin() const {
+		return elements.begin();
+	}
+	const_iterator end() const {
+		return elements.end();
+	}
+	const_iterator cbegin() const {
+		return begin();
+	}
+	const_iterator cend() const {
+		return end();
+	}
+	const_reverse_iterator rbegin() const {
+		return elements.rbegin();
+	}
+	const_reverse_iterator rend() const {
+		return elements.rend();
+	}
+	const_reverse_iterator crbegin() const {
+		return rbegin();
+	}
+	const_reverse_iterator crend() const {
+		return rend();
+	}
+
+	bool empty() const {
+		return elements.empty();
+	}
+	size_type size() const {
+		return elements.size();
+	}
+	size_type max_size() const {
+		return elements.max_size();
+	}
+	void reserve(size_type capacity) {
+		elements.reserve(capacity);
+	}
+	void shrink_to_fit() {
+		elements.shrink_to_fit();
+	}
+	void clear() {
+		elements.clear();
+	}
+
+	std::pair<iterator, bool> insert(value_type const & value) {
+		return insertUnique(value);
+	}
+	std::pair<iterator, bool> insert(value_type && value) {
+		return insertUnique(std::move(value));
+	}
+	iterator insert(const_iterator, value_type const & value) {
+		return insert(value).first;
+	}
+	iterator insert(const_iterator, value_type && value) {
+		return insert(std::move(value)).first;
+	}
+
+	// bulk insert: appends the whole range, sorts and deduplicates the new
+	// elements once and merges them with the existing ones in O(n + k log k).
+	// Like std::set, already present elements win over equivalent new ones.
+	template <typename ITERATOR>
+	void insert(ITERATOR first, ITERATOR last) {
+		auto oldSize = elements.size();
+		elements.insert(elements.end(), first, last);
+		auto middle = elements.begin() + oldSize;
+		std::stable_sort(middle, elements.end(), compare);
+		elements.erase(std::unique(middle, elements.end(), equivalence()), elements.end());
+		if (oldSize != 0) {
+			std::inplace_merge(elements.begin(), elements.begin() + oldSize, elements.end(), compare);
+			elements.erase(std::unique(elements.begin(), elements.end(), equivalence()), elements.end());
+		}
+	}
+	void insert(std::initializer_list<T> values) {
+		insert(values.begin(), values.end());
+	}
+
+	template <typename... ARGS>
+	std::pair<iterator, bool> emplace(ARGS &&... args) {
+		return insertUnique(value_type(std::forward<ARGS>(args)...));
+	}
+	template <typename... ARGS>
+	iterator emplace_hint(const_iterator, ARGS &&... args) {
+		return emplace(std::forward<ARGS>(args)...).first;
+	}
+
+	iterator erase(const_iterator pos) {
+		return elements.erase(pos);
+	}
+	iterator erase(const_iterator first, const_iterator last) {
+		return elements.erase(first, last);
+	}
+	size_type erase(key_type const & key) {
+		auto pos = find(key);
+		if (pos == end()) {
+			return 0;
+		}
+		erase(pos);
+		return 1;
+	}
+
+	void swap(flat_indexableSet & other) noexcept {
+		using std::swap;
+		swap(elements, other.elements);
+		swap(compare, other.compare);
+	}
+
+	size_type count(key_type const & key) const {
+		return find(key) != end();
+	}
+	bool contains(key_type const & key) const {
+		return find(key) != end();
+	}
+	const_iterator find(key_type const & key) const {
+		auto pos = lower_bound(key);
+		if (pos == end() || compare(key, *pos)) {
+			return end();
+		}
+		return pos;
+	}
+	const_iterator lower_bound(key_type const & key) const {
+		return std::lower_bound(begin(), end(), key, compare);
+	}
+	const_iterator upper_bound(key_type const & key) const {
+		return std::upper_bound(begin(), end(), key, compare);
+	}
+	std::pair<const_iterator, const_iterator> equal_range(key_type const & key) const {
+		return {lower_bound(key), upper_bound(key)};
+	}
+
+	key_compare key_comp() const {
+		return compare;
+	}
+	value_compare value_comp() const {
+		return compare;
+	}
+
+	// the element at position i in sorted order or end() if i >= size()
+	const_iterator nth(size_type i) const {
+		return i < size() ? begin() + i : end();
+	}
+
+	// number of elements before pos
+	size_type position(const_iterator pos) const {
+		return pos - begin();
+	}
+
+	const_reference operator[] (signed int i) const {
+		int size = this->size();
+		if(i >= size || i < - size) {
+			throw std::out_of_range("Index out of bound exception!");
+		}
+
+		if(i < 0) {
+			i = size + i;
+		}
+
+		return elements[i];
+	}
+
+	const_reference at(int i) const {
+		return (*this)[i];
+	}
+
+	const_reference front() const {
+		return (*this)[0];
+	}
+
+	const_reference back() const {
+		return (*this)[-1];
+	}
+
+	// number of elements that are smaller than value, O(log n)
+	int rank(T const & value) const {
+		return this->position(this->lower_bound(value));
+	}
+
+	// position of value, the inverse of operator[]
+	int index_of(T const & value) const {
+		auto pos = this->find(value);
+		if(pos == this->end()) {
+			throw std::out_of_range("Element not in set!");
+		}
+		return this->position(pos);
+	}
+
+	// view of the positions [first, last), negative bounds count from the back
+	indexableSlice<flat_indexableSet> slice(signed int first, signed int last) const {
+		return indexableSlice<flat_indexableSet>(*this, first, last);
+	}
+
+	friend bool operator==(flat_indexableSet const & lhs, flat_indexableSet const & rhs) {
+		return lhs.elements == rhs.elements;
+	}
+	friend bool operator!=(flat_indexableSet const & lhs, flat_indexableSet const & rhs) {
+		return !(lhs == rhs);
+	}
+	friend bool operator<(flat_indexableSet const & lhs, flat_indexableSet const & rhs) {
+		return lhs.elements < rhs.elements;
+	}
+	friend void swap(flat_indexableSet & lhs, flat_indexableSet & rhs) noexcept {
+		lhs.swap(rhs);
+	}
+
+private:
+	auto equivalence() const {
+		return [this](T const & lhs, T const & rhs) {
+			return !compare(lhs, rhs) && !compare(rhs, lhs);
+		};
+	}
+
+	template <typename V>
+	std::pair<iterator, bool> insertUnique(V && value) {
+		auto pos = std::lower_bound(elements.begin(), elements.end(), value, compare);
+		if (pos != elements.end() && !compare(value, *pos)) {
+			return {pos, false};
+		}
+		return {elements.insert(pos, std::forward<V>(value)), true};
+	}
+};
+
+#endif /* SRC_FLATINDEXABLESET_H_ */
@@ -1,14 +1,23 @@
 #ifndef SRC_INDEXABLESET_H_
 #define SRC_INDEXABLESET_H_
 
+#include "indexableSlice.h"
+#include "orderStatisticTree.h"
+
+#include <algorithm>
+#include <cstddef>
 #include <functional>
-#include <set>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
 #include <stdexcept>
+#include <vector>
 
 
-template <typename T, typename COMPARE=std::less<T>>
-struct indexableSet : std::set<T, COMPARE> {
-	using indexableSetType = std::set<T, COMPARE>;
+template <typename T, typename COMPARE=std::less<T>, typename ALLOCATOR=std::allocator<T>>
+struct indexableSet : orderStatisticTree<T, COMPARE, ALLOCATOR> {
+	using indexableSetType = orderStatisticTree<T, COMPARE, ALLOCATOR>;
 	using const_reference = typename indexableSetType::const_reference;
 	using indexableSetType :: indexableSetType;
 
@@ -22,11 +31,7 @@ struct indexableSet : std::set<T, COMPARE> {
 			i = size + i;
 		}
 
-		auto itr = this->begin();
-		for(int j = 0; j < i; j++) {
-			itr++;
-		}
-		return *itr;
+		return *this->nth(i);
 	}
 
 	const_reference at(int i) const {
@@ -40,7 +45,98 @@ struct indexableSet : std::set<T, COMPARE> {
 	const_reference back() const {
 		return (*this)[-1];
 	}
+
+	// number of elements that are smaller than value, O(log n)
+	int rank(T const & value) const {
+		return this->position(this->lower_bound(value));
+	}
+
+	// position of value, the inverse of operator[]
+	int index_of(T const & value) const {
+		auto pos = this->find(value);
+		if(pos == this->end()) {
+			throw std::out_of_range("Element not in set!");
+		}
+		return this->position(pos);
+	}
+
+	// view of the positions [first, last), negative bounds count from the back
+	indexableSlice<indexableSet> slice(signed int first, signed int last) const {
+		return indexableSlice<indexableSet>(*this, first, last);
+	}
+
+	// Set algebra in O(n + m): both sets are merged in one linear pass and
+	// the result is built from the sorted buffer in linear time. With
+	// threads > 1 large inputs are cut into key ranges that are merged
+	// concurrently.
+	indexableSet set_union(indexableSet const & other, unsigned threads = 1) const {
+		return combine(other, threads, [](auto... args) {
+			return std::set_union(args...);
+		});
+	}
+
+	indexableSet set_intersection(indexableSet const & other, unsigned threads = 1) const {
+		return combine(other, threads, [](auto... args) {
+			return std::set_intersection(args...);
+		});
+	}
+
+	indexableSet set_difference(indexableSet const & other, unsigned threads = 1) const {
+		return combine(other, threads, [](auto... args) {
+			return std::set_difference(args...);
+		});
+	}
+
+private:
+	static constexpr std::size_t minimumPartSize = 1 << 15;
+
+	template <typename OPERATION>
+	indexableSet combine(indexableSet const & other, unsigned threads, OPERATION operation) const {
+		using const_iterator = typename indexableSetType::const_iterator;
+		auto comp = this->key_comp();
+		indexableSet const & larger = this->size() >= other.size() ? *this : other;
+		indexableSet const & smaller = this->size() >= other.size() ? other : *this;
+		std::size_t parts = std::clamp<std::size_t>(larger.size() / minimumPartSize, 1, std::max(threads, 1u));
+
+		// part k covers the keys in [pivot k, pivot k+1) of both sets
+		std::vector<const_iterator> largerSplits{larger.begin()};
+		std::vector<const_iterator> smallerSplits{smaller.begin()};
+		for(std::size_t k = 1; k < parts; k++) {
+			largerSplits.push_back(larger.nth(k * larger.size() / parts));
+			smallerSplits.push_back(smaller.lower_bound(*largerSplits.back()));
+		}
+		largerSplits.push_back(larger.end());
+		smallerSplits.push_back(smaller.end());
+		auto const & thisSplits = &larger == this ? largerSplits : smallerSplits;
+		auto const & otherSplits = &larger == this ? smallerSplits : largerSplits;
+
+		std::vector<std::vector<T>> results(parts);
+		auto mergePart = [&](std::size_t k) {
+			operation(thisSplits[k], thisSplits[k + 1], otherSplits[k], otherSplits[k + 1], std::back_inserter(results[k]), comp);
+		};
+		// futures of std::async wait in their destructor, so a throwing launch
+		// or part never leaves a running worker behind, get() rethrows the
+		// exception of a worker
+		std::vector<std::future<void>> workers{};
+		for(std::size_t k = 1; k < parts; k++) {
+			workers.push_back(std::async(std::launch::async, mergePart, k));
+		}
+		mergePart(0);
+		for(auto & worker : workers) {
+			worker.get();
+		}
+
+		std::vector<T> merged = std::move(results[0]);
+		for(std::size_t k = 1; k < parts; k++) {
+			std::move(results[k].begin(), results[k].end(), std::back_inserter(merged));
+		}
+		return indexableSet(sorted_unique, std::make_move_iterator(merged.begin()), std::make_move_iterator(merged.end()), comp, this->get_allocator());
+	}
 };
 
+// indexableSet whose nodes come from a std::pmr::memory_resource, e.g. a nodeArena
+template <typename T, typename COMPARE=std::less<T>>
+using pmr_indexableSet = indexableSet<T, COMPARE, std::pmr::polymorphic_allocator<T>>;
+
 #endif /* SRC_INDEXABLESET_H_ */
 
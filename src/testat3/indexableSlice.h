@@ -0,0 +1,91 @@
+#ifndef SRC_INDEXABLESLICE_H_
+#define SRC_INDEXABLESLICE_H_
+
+#include <cstddef>
+#include <stdexcept>
+
+// Non-owning view of the positions [first, last) of an indexable set. The
+// set must provide nth(i) and outlive the slice; modifying the set shifts
+// the elements seen through the slice. Creating a slice is O(1), begin()
+// and element access are O(log n) on indexableSet and O(1) on
+// flat_indexableSet, iterating k elements adds O(k).
+template <typename SET>
+class indexableSlice {
+	SET const * set;
+	std::size_t offset;
+	std::size_t length;
+
+public:
+	using value_type = typename SET::value_type;
+	using const_reference = typename SET::const_reference;
+	using size_type = std::size_t;
+	using const_iterator = typename SET::const_iterator;
+	using iterator = const_iterator;
+
+	// first and last follow the index rules of operator[]: negative values
+	// count from the back, last may also be size() or 0 past the back.
+	// A slice with first >= last is empty.
+	indexableSlice(SET const & set, signed int first, signed int last)
+		: indexableSlice(set, 0, set.size(), first, last) {}
+
+	const_iterator begin() const {
+		return set->nth(offset);
+	}
+	const_iterator end() const {
+		return set->nth(offset + length);
+	}
+
+	bool empty() const {
+		return length == 0;
+	}
+	size_type size() const {
+		return length;
+	}
+
+	const_reference operator[] (signed int i) const {
+		int size = length;
+		if(i >= size || i < - size) {
+			throw std::out_of_range("Index out of bound exception!");
+		}
+
+		if(i < 0) {
+			i = size + i;
+		}
+
+		return *set->nth(offset + i);
+	}
+
+	const_reference at(int i) const {
+		return (*this)[i];
+	}
+
+	const_reference front() const {
+		return (*this)[0];
+	}
+
+	const_reference back() const {
+		return (*this)[-1];
+	}
+
+	indexableSlice slice(signed int first, signed int last) const {
+		return indexableSlice(*set, offset, length, first, last);
+	}
+
+private:
+	indexableSlice(SET const & set, std::size_t base, std::size_t size, signed int first, signed int last)
+		: set{&set}, offset{base + normalize(first, size)}, length{0} {
+		std::size_t end = base + normalize(last, size);
+		if (end > offset) {
+			length = end - offset;
+		}
+	}
+
+	static std::size_t normalize(signed int bound, int size) {
+		if(bound > size || bound < - size) {
+			throw std::out_of_range("Index out of bound exception!");
+		}
+		return bound < 0 ? size + bound : bound;
+	}
+};
+
+#endif /* SRC_INDEXABLESLICE_H_ */
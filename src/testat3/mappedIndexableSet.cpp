@@ -0,0 +1,54 @@
+#include "mappedIndexableSet.h"
+
+#include <cerrno>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+fileMapping::fileMapping(std::string const & path) {
+	int descriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if(descriptor < 0) {
+		throw std::system_error(errno, std::generic_category(), "Can not open " + path);
+	}
+	struct stat status{};
+	if(::fstat(descriptor, &status) != 0) {
+		int error = errno;
+		::close(descriptor);
+		throw std::system_error(error, std::generic_category(), "Can not stat " + path);
+	}
+	length = status.st_size;
+	if(length != 0) {
+		address = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+		if(address == MAP_FAILED) {
+			int error = errno;
+			::close(descriptor);
+			address = nullptr;
+			throw std::system_error(error, std::generic_category(), "Can not map " + path);
+		}
+	}
+	::close(descriptor);
+}
+
+fileMapping::fileMapping(fileMapping && other) noexcept
+	: address{std::exchange(other.address, nullptr)}, length{std::exchange(other.length, 0)} {}
+
+fileMapping & fileMapping::operator=(fileMapping && other) noexcept {
+	if(this != &other) {
+		if(address) {
+			::munmap(address, length);
+		}
+		address = std::exchange(other.address, nullptr);
+		length = std::exchange(other.length, 0);
+	}
+	return *this;
+}
+
+fileMapping::~fileMapping() {
+	if(address) {
+		::munmap(address, length);
+	}
+}
@@ -0,0 +1,298 @@
+#ifndef SRC_MAPPEDINDEXABLESET_H_
+#define SRC_MAPPEDINDEXABLESET_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+// On-disk snapshot of an indexable set in native byte order:
+//   snapshotHeader
+//   fixed size keys: count elements of elementSize bytes
+//   strings:         count + 1 uint64 offsets into the character data,
+//                    followed by the character data
+// The elements are stored in the order of the set, so the file is sorted
+// and positional access needs no parsing.
+struct snapshotHeader {
+	static constexpr char expectedMagic[4]{'I', 'X', 'S', '1'};
+	enum : std::uint32_t { fixedSize = 0, strings = 1 };
+
+	char magic[4];
+	std::uint32_t kind;
+	std::uint64_t elementSize;
+	std::uint64_t count;
+	std::uint64_t reserved;
+};
+static_assert(sizeof(snapshotHeader) == 32);
+
+// read-only memory mapping of a whole file
+class fileMapping {
+	void * address{nullptr};
+	std::size_t length{0};
+
+public:
+	explicit fileMapping(std::string const & path);
+	fileMapping(fileMapping && other) noexcept;
+	fileMapping & operator=(fileMapping && other) noexcept;
+	fileMapping(fileMapping const &) = delete;
+	fileMapping & operator=(fileMapping const &) = delete;
+	~fileMapping();
+
+	std::byte const * data() const {
+		return static_cast<std::byte const *>(address);
+	}
+	std::size_t size() const {
+		return length;
+	}
+};
+
+// writes the elements of set, which must hold trivially copyable values or
+// std::string, in iteration order
+template <typename SET>
+void writeSnapshot(SET const & set, std::string const & path) {
+	using T = typename SET::value_type;
+	constexpr bool isString = std::is_same_v<T, std::string>;
+	static_assert(isString || std::is_trivially_copyable_v<T>, "Only trivially copyable keys and std::string can be written!");
+
+	std::ofstream out{path, std::ios::binary | std::ios::trunc};
+	if(!out) {
+		throw std::runtime_error("Can not open " + path);
+	}
+	snapshotHeader header{};
+	std::memcpy(header.magic, snapshotHeader::expectedMagic, sizeof(header.magic));
+	header.kind = isString ? snapshotHeader::strings : snapshotHeader::fixedSize;
+	header.elementSize = isString ? 0 : sizeof(T);
+	header.count = set.size();
+	out.write(reinterpret_cast<char const *>(&header), sizeof(header));
+
+	if constexpr (isString) {
+		std::vector<std::uint64_t> offsets{0};
+		offsets.reserve(set.size() + 1);
+		for(auto const & value : set) {
+			offsets.push_back(offsets.back() + value.size());
+		}
+		out.write(reinterpret_cast<char const *>(offsets.data()), offsets.size() * sizeof(std::uint64_t));
+		for(auto const & value : set) {
+			out.write(value.data(), value.size());
+		}
+	} else {
+		for(auto const & value : set) {
+			out.write(reinterpret_cast<char const *>(&value), sizeof(T));
+		}
+	}
+	if(!out.flush()) {
+		throw std::runtime_error("Can not write " + path);
+	}
+}
+
+// Read-only indexable set over a file written by writeSnapshot. Opening
+// maps the file and checks the header, which is O(1) in the set size. The
+// offsets of a string are checked when it is accessed, and strings are
+// returned as std::string_view into the mapping. COMPARE must be the order
+// the set was written in, it is used by find and contains.
+template <typename T, typename COMPARE=std::less<>>
+class mappedIndexableSet {
+	static constexpr bool isString = std::is_same_v<T, std::string>;
+	static_assert(isString || std::is_trivially_copyable_v<T>, "Only trivially copyable keys and std::string can be mapped!");
+
+	fileMapping mapping;
+	std::size_t count{0};
+	std::uint64_t const * offsets{nullptr};
+	char const * characters{nullptr};
+	T const * elements{nullptr};
+	COMPARE compare{};
+
+public:
+	using value_type = std::conditional_t<isString, std::string_view, T>;
+	using const_reference = std::conditional_t<isString, std::string_view, T const &>;
+	using size_type = std::size_t;
+
+	class const_iterator {
+		mappedIndexableSet const * set{nullptr};
+		std::ptrdiff_t index{0};
+	public:
+		using iterator_category = std::random_access_iterator_tag;
+		using value_type = mappedIndexableSet::value_type;
+		using difference_type = std::ptrdiff_t;
+		using pointer = void;
+		using reference = const_reference;
+
+		const_iterator() = default;
+		const_iterator(mappedIndexableSet const * set, std::ptrdiff_t index) : set{set}, index{index} {}
+
+		reference operator*() const {
+			return set->element(index);
+		}
+		reference operator[](difference_type n) const {
+			return set->element(index + n);
+		}
+		const_iterator & operator++() {
+			++index;
+			return *this;
+		}
+		const_iterator operator++(int) {
+			auto old = *this;
+			++index;
+			return old;
+		}
+		const_iterator & operator--() {
+			--index;
+			return *this;
+		}
+		const_iterator operator--(int) {
+			auto old = *this;
+			--index;
+			return old;
+		}
+		const_iterator & operator+=(difference_type n) {
+			index += n;
+			return *this;
+		}
+		const_iterator & operator-=(difference_type n) {
+			index -= n;
+			return *this;
+		}
+		friend const_iterator operator+(const_iterator it, difference_type n) {
+			return it += n;
+		}
+		friend const_iterator operator+(difference_type n, const_iterator it) {
+			return it += n;
+		}
+		friend const_iterator operator-(const_iterator it, difference_type n) {
+			return it -= n;
+		}
+		friend difference_type operator-(const_iterator const & lhs, const_iterator const & rhs) {
+			return lhs.index - rhs.index;
+		}
+		friend bool operator==(const_iterator const & lhs, const_iterator const & rhs) {
+			return lhs.index == rhs.index;
+		}
+		friend bool operator!=(const_iterator const & lhs, const_iterator const & rhs) {
+			return lhs.index != rhs.index;
+		}
+		friend bool operator<(const_iterator const & lhs, const_iterator const & rhs) {
+			return lhs.index < rhs.index;
+		}
+		friend bool operator>(const_iterator const & lhs, const_iterator const & rhs) {
+			return lhs.index > rhs.index;
+		}
+		friend bool operator<=(const_iterator const & lhs, const_iterator const & rhs) {
+			return lhs.index <= rhs.index;
+		}
+		friend bool operator>=(const_iterator const & lhs, const_iterator const & rhs) {
+			return lhs.index >= rhs.index;
+		}
+	};
+	using iterator = const_iterator;
+
+	explicit mappedIndexableSet(std::string const & path, COMPARE const & comp = COMPARE{})
+		: mapping{path}, compare{comp} {
+		if(mapping.size() < sizeof(snapshotHeader)) {
+			throw std::runtime_error(path + " is not an indexableSet snapshot!");
+		}
+		snapshotHeader header{};
+		std::memcpy(&header, mapping.data(), sizeof(header));
+		if(std::memcmp(header.magic, snapshotHeader::expectedMagic, sizeof(header.magic)) != 0) {
+			throw std::runtime_error(path + " is not an indexableSet snapshot!");
+		}
+		std::byte const * payload = mapping.data() + sizeof(snapshotHeader);
+		std::size_t available = mapping.size() - sizeof(snapshotHeader);
+		count = header.count;
+		if constexpr (isString) {
+			if(header.kind != snapshotHeader::strings || available / sizeof(std::uint64_t) <= count) {
+				throw std::runtime_error(path + " does not contain strings!");
+			}
+			offsets = reinterpret_cast<std::uint64_t const *>(payload);
+			characters = reinterpret_cast<char const *>(offsets + count + 1);
+			if(offsets[count] > available - (count + 1) * sizeof(std::uint64_t)) {
+				throw std::runtime_error(path + " is truncated!");
+			}
+			if(offsets[0] != 0) {
+				throw std::runtime_error(path + " has corrupt string offsets!");
+			}
+		} else {
+			if(header.kind != snapshotHeader::fixedSize || header.elementSize != sizeof(T) || available / sizeof(T) < count) {
+				throw std::runtime_error(path + " does not contain elements of this type!");
+			}
+			elements = reinterpret_cast<T const *>(payload);
+		}
+	}
+
+	const_iterator begin() const {
+		return const_iterator{this, 0};
+	}
+	const_iterator end() const {
+		return const_iterator{this, static_cast<std::ptrdiff_t>(count)};
+	}
+
+	bool empty() const {
+		return count == 0;
+	}
+	size_type size() const {
+		return count;
+	}
+
+	const_reference operator[] (signed int i) const {
+		int size = this->size();
+		if(i >= size || i < - size) {
+			throw std::out_of_range("Index out of bound exception!");
+		}
+
+		if(i < 0) {
+			i = size + i;
+		}
+
+		return element(i);
+	}
+
+	const_reference at(int i) const {
+		return (*this)[i];
+	}
+
+	const_reference front() const {
+		return (*this)[0];
+	}
+
+	const_reference back() const {
+		return (*this)[-1];
+	}
+
+	const_iterator lower_bound(value_type const & value) const {
+		return std::lower_bound(begin(), end(), value, compare);
+	}
+
+	const_iterator find(value_type const & value) const {
+		auto pos = lower_bound(value);
+		if(pos == end() || compare(value, *pos)) {
+			return end();
+		}
+		return pos;
+	}
+
+	bool contains(value_type const & value) const {
+		return find(value) != end();
+	}
+
+private:
+	const_reference element(std::size_t i) const {
+		if constexpr (isString) {
+			// the string must lie inside the character data
+			if(offsets[i] > offsets[i + 1] || offsets[i + 1] > offsets[count]) {
+				throw std::runtime_error("Snapshot has corrupt string offsets!");
+			}
+			return std::string_view{characters + offsets[i], offsets[i + 1] - offsets[i]};
+		} else {
+			return elements[i];
+		}
+	}
+};
+
+#endif /* SRC_MAPPEDINDEXABLESET_H_ */
@@ -0,0 +1,72 @@
+#include "nodeArena.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace {
+
+std::size_t roundUp(std::size_t value, std::size_t alignment) {
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+
+}
+
+nodeArena::nodeArena(std::size_t initialSize, std::pmr::memory_resource * upstream)
+	: upstream{upstream}, nextChunkSize{std::max(initialSize, sizeof(chunk) + maxRecycledSize)} {}
+
+nodeArena::~nodeArena() {
+	release();
+}
+
+void nodeArena::release() {
+	while (chunks) {
+		chunk * next = chunks->next;
+		upstream->deallocate(chunks, chunks->size, alignof(std::max_align_t));
+		chunks = next;
+	}
+	current = limit = nullptr;
+	freeLists.fill(nullptr);
+}
+
+void * nodeArena::do_allocate(std::size_t bytes, std::size_t alignment) {
+	std::size_t size = roundUp(std::max(bytes, sizeof(freeBlock)), granularity);
+	bool recyclable = size <= maxRecycledSize && alignment <= granularity;
+	if (recyclable) {
+		freeBlock *& list = freeLists[size / granularity - 1];
+		if (list) {
+			freeBlock * block = list;
+			list = block->next;
+			return block;
+		}
+	}
+	auto address = reinterpret_cast<std::uintptr_t>(current);
+	std::size_t padding = roundUp(address, alignment) - address;
+	if (current == nullptr || static_cast<std::size_t>(limit - current) < padding + size) {
+		grow(size + alignment);
+		address = reinterpret_cast<std::uintptr_t>(current);
+		padding = roundUp(address, alignment) - address;
+	}
+	std::byte * result = current + padding;
+	current = result + size;
+	return result;
+}
+
+void nodeArena::do_deallocate(void * p, std::size_t bytes, std::size_t alignment) {
+	std::size_t size = roundUp(std::max(bytes, sizeof(freeBlock)), granularity);
+	if (size <= maxRecycledSize && alignment <= granularity) {
+		freeBlock *& list = freeLists[size / granularity - 1];
+		list = ::new (p) freeBlock{list};
+	}
+}
+
+bool nodeArena::do_is_equal(std::pmr::memory_resource const & other) const noexcept {
+	return this == &other;
+}
+
+void nodeArena::grow(std::size_t minimumSize) {
+	std::size_t size = std::max(nextChunkSize, roundUp(sizeof(chunk), granularity) + minimumSize);
+	chunks = ::new (upstream->allocate(size, alignof(std::max_align_t))) chunk{chunks, size};
+	current = reinterpret_cast<std::byte *>(chunks) + roundUp(sizeof(chunk), granularity);
+	limit = reinterpret_cast<std::byte *>(chunks) + size;
+	nextChunkSize = std::min(size * 2, maxChunkSize);
+}
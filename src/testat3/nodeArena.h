@@ -0,0 +1,56 @@
+#ifndef SRC_NODEARENA_H_
+#define SRC_NODEARENA_H_
+
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+
+// Memory resource for node based containers such as pmr_indexableSet.
+// Memory is carved from chunks obtained from the upstream resource, each
+// twice as large as the previous one up to 64 MiB. Freed blocks up to
+// maxRecycledSize bytes are kept in per size free lists and reused, larger
+// ones are only reclaimed by release(). release() and the destructor return
+// all chunks at once. Not thread safe.
+class nodeArena : public std::pmr::memory_resource {
+	static constexpr std::size_t granularity = alignof(std::max_align_t);
+	static constexpr std::size_t maxRecycledSize = 256;
+	static constexpr std::size_t maxChunkSize = 64 * 1024 * 1024;
+
+	struct chunk {
+		chunk * next;
+		std::size_t size;
+	};
+	struct freeBlock {
+		freeBlock * next;
+	};
+
+	std::pmr::memory_resource * upstream;
+	std::size_t nextChunkSize;
+	chunk * chunks{nullptr};
+	std::byte * current{nullptr};
+	std::byte * limit{nullptr};
+	std::array<freeBlock *, maxRecycledSize / granularity> freeLists{};
+
+public:
+	explicit nodeArena(std::size_t initialSize = 64 * 1024, std::pmr::memory_resource * upstream = std::pmr::get_default_resource());
+	nodeArena(nodeArena const &) = delete;
+	nodeArena & operator=(nodeArena const &) = delete;
+	~nodeArena() override;
+
+	// frees all memory, every container using the arena must be gone
+	void release();
+
+	std::pmr::memory_resource * upstream_resource() const {
+		return upstream;
+	}
+
+protected:
+	void * do_allocate(std::size_t bytes, std::size_t alignment) override;
+	void do_deallocate(void * p, std::size_t bytes, std::size_t alignment) override;
+	bool do_is_equal(std::pmr::memory_resource const & other) const noexcept override;
+
+private:
+	void grow(std::size_t minimumSize);
+};
+
+#endif /* SRC_NODEARENA_H_ */
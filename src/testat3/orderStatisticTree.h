@@ -0,0 +1,685 @@
+#ifndef SRC_ORDERSTATISTICTREE_H_
+#define SRC_ORDERSTATISTICTREE_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <utility>
+
+// Tag for constructors whose input is already sorted and free of duplicates
+struct sorted_unique_t {
+	explicit sorted_unique_t() = default;
+};
+inline constexpr sorted_unique_t sorted_unique{};
+
+// Weight-balanced search tree (Hirai/Yamamoto parameters delta=3, gamma=2).
+// Every node stores the size of its subtree. The sizes are the balance
+// criterion and allow selecting the i-th element or computing the position
+// of an element in O(log n). The interface follows std::set, nodes are
+// obtained from ALLOCATOR rebound to the node type.
+template <typename T, typename COMPARE=std::less<T>, typename ALLOCATOR=std::allocator<T>>
+class orderStatisticTree {
+	struct nodeBase {
+		nodeBase * parent{nullptr};
+		nodeBase * left{nullptr};
+		nodeBase * right{nullptr};
+		std::size_t size{0};
+	};
+
+	struct node : nodeBase {
+		template <typename... ARGS>
+		explicit node(ARGS &&... args) : value(std::forward<ARGS>(args)...) {}
+		T value;
+	};
+
+	using nodeAllocator = typename std::allocator_traits<ALLOCATOR>::template rebind_alloc<node>;
+	using nodeTraits = std::allocator_traits<nodeAllocator>;
+
+	static constexpr std::size_t delta = 3;
+	static constexpr std::size_t gamma = 2;
+
+	// header.left is the root, the root's parent is the header and the
+	// header itself is the end() position
+	nodeBase header{};
+	COMPARE compare{};
+	[[no_unique_address]] nodeAllocator allocator{};
+
+public:
+	using key_type = T;
+	using value_type = T;
+	using key_compare = COMPARE;
+	using value_compare = COMPARE;
+	using allocator_type = ALLOCATOR;
+	using size_type = std::size_t;
+	using difference_type = std::ptrdiff_t;
+	using reference = value_type &;
+	using const_reference = value_type const &;
+	using pointer = value_type *;
+	using const_pointer = value_type const *;
+
+	class const_iterator {
+		friend class orderStatisticTree;
+		nodeBase const * current{nullptr};
+		explicit const_iterator(nodeBase const * n) : current{n} {}
+	public:
+		using iterator_category = std::bidirectional_iterator_tag;
+		using value_type = T;
+		using difference_type = std::ptrdiff_t;
+		using pointer = T const *;
+		using reference = T const &;
+
+		const_iterator() = default;
+
+		reference operator*() const {
+			return static_cast<node const *>(current)->value;
+		}
+		pointer operator->() const {
+			return &**this;
+		}
+		const_iterator & operator++() {
+			current = successor(current);
+			return *this;
+		}
+		const_iterator operator++(int) {
+			auto old = *this;
+			++*this;
+			return old;
+		}
+		const_iterator & operator--() {
+			current = predecessor(current);
+			return *this;
+		}
+		const_iterator operator--(int) {
+			auto old = *this;
+			--*this;
+			return old;
+		}
+		friend bool operator==(const_iterator const & lhs, const_iterator const & rhs) {
+			return lhs.current == rhs.current;
+		}
+		friend bool operator!=(const_iterator const & lhs, const_iterator const & rhs) {
+			return !(lhs == rhs);
+		}
+	};
+	using iterator = const_iterator;
+	using reverse_iterator = std::reverse_iterator<iterator>;
+	using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+	orderStatisticTree() = default;
+
+	explicit orderStatisticTree(COMPARE const & comp, ALLOCATOR const & alloc = ALLOCATOR{})
+		: compare{comp}, allocator{alloc} {}
+
+	explicit orderStatisticTree(ALLOCATOR const & alloc) : allocator{alloc} {}
+
+	template <typename ITERATOR>
+	orderStatisticTree(ITERATOR first, ITERATOR last, COMPARE const & comp = COMPARE{}, ALLOCATOR const & alloc = ALLOCATOR{})
+		: compare{comp}, allocator{alloc} {
+		insert(first, last);
+	}
+
+	template <typename ITERATOR>
+	orderStatisticTree(ITERATOR first, ITERATOR last, ALLOCATOR const & alloc)
+		: orderStatisticTree(first, last, COMPARE{}, alloc) {}
+
+	orderStatisticTree(std::initializer_list<T> values, COMPARE const & comp = COMPARE{}, ALLOCATOR const & alloc = ALLOCATOR{})
+		: orderStatisticTree(values.begin(), values.end(), comp, alloc) {}
+
+	orderStatisticTree(std::initializer_list<T> values, ALLOCATOR const & alloc)
+		: orderStatisticTree(values.begin(), values.end(), COMPARE{}, alloc) {}
+
+	// O(n) construction from a range that is sorted by comp and contains no
+	// equivalent elements, the result is perfectly balanced
+	template <typename ITERATOR>
+	orderStatisticTree(sorted_unique_t, ITERATOR first, ITERATOR last, COMPARE const & comp = COMPARE{}, ALLOCATOR const & alloc = ALLOCATOR{})
+		: compare{comp}, allocator{alloc} {
+		adoptRoot(buildSorted(first, std::distance(first, last), &header));
+	}
+
+	orderStatisticTree(orderStatisticTree const & other)
+		: orderStatisticTree(other, nodeTraits::select_on_container_copy_construction(other.allocator)) {}
+
+	orderStatisticTree(orderStatisticTree const & other, ALLOCATOR const & alloc)
+		: compare{other.compare}, allocator{alloc} {
+		adoptRoot(clone(other.root(), &header));
+	}
+
+	orderStatisticTree(orderStatisticTree && other) noexcept
+		: compare{std::move(other.compare)}, allocator{std::move(other.allocator)} {
+		adoptRoot(other.root());
+		other.header.left = nullptr;
+	}
+
+	orderStatisticTree(orderStatisticTree && other, ALLOCATOR const & alloc)
+		: compare{other.compare}, allocator{alloc} {
+		if (allocator == other.allocator) {
+			adoptRoot(other.root());
+			other.header.left = nullptr;
+		} else {
+			adoptRoot(clone(other.root(), &header));
+		}
+	}
+
+	orderStatisticTree & operator=(orderStatisticTree const & other) {
+		if (this != &other) {
+			clear();
+			if constexpr (nodeTraits::propagate_on_container_copy_assignment::value) {
+				allocator = other.allocator;
+			}
+			compare = other.compare;
+			adoptRoot(clone(other.root(), &header));
+		}
+		return *this;
+	}
+
+	orderStatisticTree & operator=(orderStatisticTree && other)
+		noexcept(nodeTraits::propagate_on_container_move_assignment::value || nodeTraits::is_always_equal::value) {
+		if (this != &other) {
+			clear();
+			compare = std::move(other.compare);
+			if constexpr (nodeTraits::propagate_on_container_move_assignment::value) {
+				allocator = std::move(other.allocator);
+			}
+			if (allocator == other.allocator) {
+				adoptRoot(other.root());
+				other.header.left = nullptr;
+			} else {
+				adoptRoot(clone(other.root(), &header));
+			}
+		}
+		return *this;
+	}
+
+	orderStatisticTree & operator=(std::initializer_list<T> values) {
+		clear();
+		insert(values);
+		return *this;
+	}
+
+	~orderStatisticTree() {
+		destroySubtree(root());
+	}
+
+	allocator_type get_allocator() const {
+		return allocator_type(allocator);
+	}
+
+	const_iterator begin() const {
+		return const_iterator{root() ? leftmost(root()) : &header};
+	}
+	const_iterator end() const {
+		return const_iterator{&header};
+	}
+	const_iterator cbegin() const {
+		return begin();
+	}
+	const_iterator cend() const {
+		return end();
+	}
+	const_reverse_iterator rbegin() const {
+		return const_reverse_iterator{end()};
+	}
+	const_reverse_iterator rend() const {
+		return const_reverse_iterator{begin()};
+	}
+	const_reverse_iterator crbegin() const {
+		return rbegin();
+	}
+	const_reverse_iterator crend() const {
+		return rend();
+	}
+
+	bool empty() const {
+		return root() == nullptr;
+	}
+	size_type size() const {
+		return sizeOf(root());
+	}
+	size_type max_size() const {
+		return std::numeric_limits<difference_type>::max() / sizeof(node);
+	}
+
+	void clear() {
+		destroySubtree(root());
+		header.left = nullptr;
+	}
+
+	std::pair<iterator, bool> insert(value_type const & value) {
+		return insertUnique(value);
+	}
+	std::pair<iterator, bool> insert(value_type && value) {
+		return insertUnique(std::move(value));
+	}
+	iterator insert(const_iterator, value_type const & value) {
+		return insert(value).first;
+	}
+	iterator insert(const_iterator, value_type && value) {
+		return insert(std::move(value)).first;
+	}
+	template <typename ITERATOR>
+	void insert(ITERATOR first, ITERATOR last) {
+		for (; first != last; ++first) {
+			insertUnique(*first);
+		}
+	}
+	void insert(std::initializer_list<T> values) {
+		insert(values.begin(), values.end());
+	}
+
+	template <typename... ARGS>
+	std::pair<iterator, bool> emplace(ARGS &&... args) {
+		node * n = createNode(std::forward<ARGS>(args)...);
+		auto [parent, link] = findLink(n->value);
+		if (*link) {
+			destroyNode(n);
+			return {iterator{*link}, false};
+		}
+		return {iterator{attach(n, parent, link)}, true};
+	}
+	template <typename... ARGS>
+	iterator emplace_hint(const_iterator, ARGS &&... args) {
+		return emplace(std::forward<ARGS>(args)...).first;
+	}
+
+	iterator erase(const_iterator pos) {
+		auto next = std::next(pos);
+		unlink(const_cast<nodeBase *>(pos.current));
+		return next;
+	}
+	iterator erase(const_iterator first, const_iterator last) {
+		while (first != last) {
+			first = erase(first);
+		}
+		return last;
+	}
+	size_type erase(key_type const & key) {
+		auto pos = find(key);
+		if (pos == end()) {
+			return 0;
+		}
+		erase(pos);
+		return 1;
+	}
+
+	void swap(orderStatisticTree & other) noexcept {
+		using std::swap;
+		nodeBase * mine = root();
+		nodeBase * theirs = other.root();
+		adoptRoot(theirs);
+		other.adoptRoot(mine);
+		swap(compare, other.compare);
+		if constexpr (nodeTraits::propagate_on_container_swap::value) {
+			swap(allocator, other.allocator);
+		}
+	}
+
+	size_type count(key_type const & key) const {
+		return find(key) != end();
+	}
+	bool contains(key_type const & key) const {
+		return find(key) != end();
+	}
+	const_iterator find(key_type const & key) const {
+		auto pos = lower_bound(key);
+		if (pos == end() || compare(key, *pos)) {
+			return end();
+		}
+		return pos;
+	}
+	const_iterator lower_bound(key_type const & key) const {
+		nodeBase const * result = &header;
+		for (nodeBase const * n = root(); n;) {
+			if (!compare(valueOf(n), key)) {
+				result = n;
+				n = n->left;
+			} else {
+				n = n->right;
+			}
+		}
+		return const_iterator{result};
+	}
+	const_iterator upper_bound(key_type const & key) const {
+		nodeBase const * result = &header;
+		for (nodeBase const * n = root(); n;) {
+			if (compare(key, valueOf(n))) {
+				result = n;
+				n = n->left;
+			} else {
+				n = n->right;
+			}
+		}
+		return const_iterator{result};
+	}
+	std::pair<const_iterator, const_iterator> equal_range(key_type const & key) const {
+		return {lower_bound(key), upper_bound(key)};
+	}
+
+	key_compare key_comp() const {
+		return compare;
+	}
+	value_compare value_comp() const {
+		return compare;
+	}
+
+	// the element at position i in sorted order or end() if i >= size()
+	const_iterator nth(size_type i) const {
+		nodeBase const * n = root();
+		while (n) {
+			size_type leftSize = sizeOf(n->left);
+			if (i < leftSize) {
+				n = n->left;
+			} else if (i == leftSize) {
+				return const_iterator{n};
+			} else {
+				i -= leftSize + 1;
+				n = n->right;
+			}
+		}
+		return end();
+	}
+
+	// number of elements before pos, size() for end()
+	size_type position(const_iterator pos) const {
+		nodeBase const * n = pos.current;
+		if (n == &header) {
+			return size();
+		}
+		size_type result = sizeOf(n->left);
+		for (; n->parent != &header; n = n->parent) {
+			if (n == n->parent->right) {
+				result += sizeOf(n->parent->left) + 1;
+			}
+		}
+		return result;
+	}
+
+	friend bool operator==(orderStatisticTree const & lhs, orderStatisticTree const & rhs) {
+		return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+	}
+	friend bool operator!=(orderStatisticTree const & lhs, orderStatisticTree const & rhs) {
+		return !(lhs == rhs);
+	}
+	friend bool operator<(orderStatisticTree const & lhs, orderStatisticTree const & rhs) {
+		return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+	}
+	friend void swap(orderStatisticTree & lhs, orderStatisticTree & rhs) noexcept {
+		lhs.swap(rhs);
+	}
+
+private:
+	nodeBase * root() const {
+		return header.left;
+	}
+
+	void adoptRoot(nodeBase * newRoot) {
+		header.left = newRoot;
+		if (newRoot) {
+			newRoot->parent = &header;
+		}
+	}
+
+	static size_type sizeOf(nodeBase const * n) {
+		return n ? n->size : 0;
+	}
+
+	static T const & valueOf(nodeBase const * n) {
+		return static_cast<node const *>(n)->value;
+	}
+
+	static nodeBase const * leftmost(nodeBase const * n) {
+		while (n->left) {
+			n = n->left;
+		}
+		return n;
+	}
+
+	static nodeBase const * rightmost(nodeBase const * n) {
+		while (n->right) {
+			n = n->right;
+		}
+		return n;
+	}
+
+	static nodeBase const * successor(nodeBase const * n) {
+		if (n->right) {
+			return leftmost(n->right);
+		}
+		nodeBase const * p = n->parent;
+		while (n == p->right) {
+			n = p;
+			p = p->parent;
+		}
+		return p;
+	}
+
+	static nodeBase const * predecessor(nodeBase const * n) {
+		if (n->parent == nullptr) {
+			return rightmost(n->left);
+		}
+		if (n->left) {
+			return rightmost(n->left);
+		}
+		nodeBase const * p = n->parent;
+		while (n == p->left) {
+			n = p;
+			p = p->parent;
+		}
+		return p;
+	}
+
+	template <typename... ARGS>
+	node * createNode(ARGS &&... args) {
+		node * n = nodeTraits::allocate(allocator, 1);
+		try {
+			nodeTraits::construct(allocator, n, std::forward<ARGS>(args)...);
+		} catch (...) {
+			nodeTraits::deallocate(allocator, n, 1);
+			throw;
+		}
+		n->size = 1;
+		return n;
+	}
+
+	void destroyNode(nodeBase * n) {
+		node * current = static_cast<node *>(n);
+		nodeTraits::destroy(allocator, current);
+		nodeTraits::deallocate(allocator, current, 1);
+	}
+
+	void destroySubtree(nodeBase * n) {
+		while (n) {
+			destroySubtree(n->right);
+			nodeBase * left = n->left;
+			destroyNode(n);
+			n = left;
+		}
+	}
+
+	nodeBase * clone(nodeBase const * source, nodeBase * parent) {
+		if (!source) {
+			return nullptr;
+		}
+		node * n = createNode(valueOf(source));
+		n->parent = parent;
+		n->size = source->size;
+		try {
+			n->left = clone(source->left, n);
+			n->right = clone(source->right, n);
+		} catch (...) {
+			destroySubtree(n);
+			throw;
+		}
+		return n;
+	}
+
+	// builds the first n elements of the range in order, the median of each
+	// subrange becomes the subtree root
+	template <typename ITERATOR>
+	nodeBase * buildSorted(ITERATOR & next, size_type n, nodeBase * parent) {
+		if (n == 0) {
+			return nullptr;
+		}
+		size_type leftSize = n / 2;
+		nodeBase * left = buildSorted(next, leftSize, nullptr);
+		node * middle = nullptr;
+		try {
+			middle = createNode(*next);
+		} catch (...) {
+			destroySubtree(left);
+			throw;
+		}
+		++next;
+		middle->parent = parent;
+		middle->size = n;
+		middle->left = left;
+		if (left) {
+			left->parent = middle;
+		}
+		try {
+			middle->right = buildSorted(next, n - leftSize - 1, middle);
+		} catch (...) {
+			destroySubtree(middle);
+			throw;
+		}
+		return middle;
+	}
+
+	// parent and child slot where value belongs, the slot is occupied if
+	// an equivalent element is already present
+	std::pair<nodeBase *, nodeBase **> findLink(T const & value) {
+		nodeBase * parent = &header;
+		nodeBase ** link = &header.left;
+		while (*link) {
+			T const & current = valueOf(*link);
+			if (compare(value, current)) {
+				parent = *link;
+				link = &parent->left;
+			} else if (compare(current, value)) {
+				parent = *link;
+				link = &parent->right;
+			} else {
+				break;
+			}
+		}
+		return {parent, link};
+	}
+
+	template <typename V>
+	std::pair<iterator, bool> insertUnique(V && value) {
+		auto [parent, link] = findLink(value);
+		if (*link) {
+			return {iterator{*link}, false};
+		}
+		return {iterator{attach(createNode(std::forward<V>(value)), parent, link)}, true};
+	}
+
+	nodeBase * attach(nodeBase * n, nodeBase * parent, nodeBase ** link) {
+		n->parent = parent;
+		*link = n;
+		rebalanceUpwards(parent);
+		return n;
+	}
+
+	void unlink(nodeBase * z) {
+		nodeBase * fixFrom = z->parent;
+		if (z->left && z->right) {
+			// replace z by its successor s, which has no left child
+			nodeBase * s = const_cast<nodeBase *>(leftmost(z->right));
+			if (s->parent == z) {
+				fixFrom = s;
+			} else {
+				fixFrom = s->parent;
+				fixFrom->left = s->right;
+				if (s->right) {
+					s->right->parent = fixFrom;
+				}
+				s->right = z->right;
+				z->right->parent = s;
+			}
+			s->left = z->left;
+			z->left->parent = s;
+			s->parent = z->parent;
+			replaceChild(z->parent, z, s);
+		} else {
+			nodeBase * child = z->left ? z->left : z->right;
+			if (child) {
+				child->parent = z->parent;
+			}
+			replaceChild(z->parent, z, child);
+		}
+		destroyNode(z);
+		rebalanceUpwards(fixFrom);
+	}
+
+	static void replaceChild(nodeBase * parent, nodeBase * oldChild, nodeBase * newChild) {
+		if (parent->left == oldChild) {
+			parent->left = newChild;
+		} else {
+			parent->right = newChild;
+		}
+	}
+
+	void rebalanceUpwards(nodeBase * n) {
+		while (n != &header) {
+			n->size = sizeOf(n->left) + sizeOf(n->right) + 1;
+			n = balance(n)->parent;
+		}
+	}
+
+	static nodeBase * balance(nodeBase * x) {
+		size_type leftSize = sizeOf(x->left);
+		size_type rightSize = sizeOf(x->right);
+		if (leftSize + rightSize <= 1) {
+			return x;
+		}
+		if (rightSize + 1 > delta * (leftSize + 1)) {
+			if (sizeOf(x->right->left) + 1 >= gamma * (sizeOf(x->right->right) + 1)) {
+				rotateRight(x->right);
+			}
+			return rotateLeft(x);
+		}
+		if (leftSize + 1 > delta * (rightSize + 1)) {
+			if (sizeOf(x->left->right) + 1 >= gamma * (sizeOf(x->left->left) + 1)) {
+				rotateLeft(x->left);
+			}
+			return rotateRight(x);
+		}
+		return x;
+	}
+
+	static nodeBase * rotateLeft(nodeBase * x) {
+		nodeBase * y = x->right;
+		x->right = y->left;
+		if (y->left) {
+			y->left->parent = x;
+		}
+		y->parent = x->parent;
+		replaceChild(x->parent, x, y);
+		y->left = x;
+		x->parent = y;
+		y->size = x->size;
+		x->size = sizeOf(x->left) + sizeOf(x->right) + 1;
+		return y;
+	}
+
+	static nodeBase * rotateRight(nodeBase * x) {
+		nodeBase * y = x->left;
+		x->left = y->right;
+		if (y->right) {
+			y->right->parent = x;
+		}
+		y->parent = x->parent;
+		replaceChild(x->parent, x, y);
+		y->right = x;
+		x->parent = y;
+		y->size = x->size;
+		x->size = sizeOf(x->left) + sizeOf(x->right) + 1;
+		return y;
+	}
+};
+
+#endif /* SRC_ORDERSTATISTICTREE_H_ */